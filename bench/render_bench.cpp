@@ -0,0 +1,271 @@
+#include "game.h"
+#include "resource_cache.h"
+#include "label_placer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Headless render benchmark: builds the game without a window, seeds a
+// fixed player, quiz and leaderboard, then records and submits every game
+// state into an offscreen RenderTexture and prints per-state timings and
+// allocation counts as JSON. The game logs to stdout, so the JSON goes to
+// a file.
+//
+// Usage: astrolearn_bench [frames] [output.json]
+
+static std::atomic<unsigned long long> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+const unsigned int BENCH_SEED = 20240901;
+const int WARMUP_FRAMES = 10;
+// Large enough that drawing every player card would dominate the frame.
+const int ROSTER_SIZE = 100000;
+const double LEADERBOARD_SCROLL_PER_FRAME = 45.0;
+const int PLACEMENT_LABELS = 5000;
+
+struct StateResult {
+    std::string name;
+    double recordMs = 0.0;
+    double submitMs = 0.0;
+    double allocationsPerFrame = 0.0;
+    size_t drawCalls = 0;
+    size_t textObjects = 0;
+};
+
+struct PlacementResult {
+    double ms = 0.0;
+    double shown = 0.0;
+};
+
+void seedGame(Game& game) {
+    game.getPlayer() = std::make_unique<Player>("bench_player");
+    Player& player = *game.getPlayer();
+    player.addScore(1250);
+    player.unlockAchievement("quiz_beginner");
+    player.recordStudy("Earth", 120);
+    player.recordStudy("Mars", 90);
+    
+    // Not unlockPlanet(), which saves the game.
+    for (const auto& name : {"Mercury", "Venus", "Earth", "Mars", "Jupiter"}) {
+        game.planetUnlockStatus[name] = true;
+    }
+    
+    std::vector<Database::PlayerData> roster;
+    for (int i = 0; i < ROSTER_SIZE; ++i) {
+        Database::PlayerData data;
+        data.name = "player_" + std::to_string(i);
+        data.totalScore = 500000 - i * 5;
+        data.quizzesCompleted = 40 - (i % 37);
+        data.createdAt = 1700000000 + i * 3600;
+        data.lastPlayed = 1710000000 + i * 1800;
+        roster.push_back(data);
+    }
+    game.getLeaderboard().setFixedRoster(std::move(roster));
+    
+    game.getQuiz()->startNewQuiz("", 10);
+    game.getQuiz()->submitAnswer(0);
+    game.setSelectedPlanet("Earth");
+}
+
+StateResult measureState(Game& game, Game::GameState state, sf::RenderTexture& target, int frames) {
+    game.switchState(state);
+    
+    StateResult result;
+    result.name = Game::getStateName(state);
+    
+    DrawList frame;
+    sf::Clock clock;
+    sf::Time recordTime;
+    sf::Time submitTime;
+    unsigned long long allocations = 0;
+    
+    for (int i = -WARMUP_FRAMES; i < frames; ++i) {
+        bool measured = i >= 0;
+        
+        if (game.getSolarSystem() && state == Game::GameState::SOLAR_SYSTEM) {
+            game.getSolarSystem()->update(1.0f / 60.0f);
+        }
+        if (state == Game::GameState::STATISTICS) {
+            game.getLeaderboardList().scrollBy(LEADERBOARD_SCROLL_PER_FRAME);
+            game.getLeaderboardList().update(1.0f / 60.0f);
+        }
+        
+        unsigned long long allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        clock.restart();
+        
+        frame.reset();
+        frame.setView(target.getDefaultView());
+        game.recordFrame(frame);
+        sf::Time recorded = clock.restart();
+        
+        frame.submit(target);
+        target.display();
+        sf::Time submitted = clock.restart();
+        
+        if (measured) {
+            recordTime += recorded;
+            submitTime += submitted;
+            allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        }
+    }
+    
+    result.recordMs = recordTime.asMicroseconds() / 1000.0 / frames;
+    result.submitMs = submitTime.asMicroseconds() / 1000.0 / frames;
+    result.allocationsPerFrame = static_cast<double>(allocations) / frames;
+    result.drawCalls = frame.size();
+    result.textObjects = frame.getTextCount();
+    return result;
+}
+
+// Declutters PLACEMENT_LABELS labels scattered over the screen and drifting
+// a little each frame, as crowded orbits would.
+PlacementResult measureLabelPlacement(int frames) {
+    const sf::Vector2f screen(1024.0f, 768.0f);
+    const float margin = 80.0f;
+    const sf::FloatRect bounds(-margin, -margin, screen.x + 2 * margin, screen.y + 2 * margin);
+    
+    std::mt19937 random(BENCH_SEED);
+    std::uniform_real_distribution<float> x(0.0f, screen.x);
+    std::uniform_real_distribution<float> y(0.0f, screen.y);
+    std::uniform_real_distribution<float> radius(1.0f, 12.0f);
+    std::uniform_real_distribution<float> width(30.0f, 90.0f);
+    std::uniform_int_distribution<int> priority(1000, 4999);
+    
+    std::vector<LabelPlacer::Candidate> candidates;
+    for (int i = 0; i < PLACEMENT_LABELS; ++i) {
+        candidates.push_back({sf::Vector2f(x(random), y(random)), radius(random), sf::Vector2f(width(random), 14.0f),
+                              static_cast<uint16_t>(priority(random)), static_cast<uint32_t>(i)});
+    }
+    
+    LabelPlacer placer;
+    PlacementResult result;
+    sf::Clock clock;
+    sf::Time placeTime;
+    size_t shown = 0;
+    
+    for (int i = -WARMUP_FRAMES; i < frames; ++i) {
+        // Wrapping keeps the whole set on screen, where every label is
+        // tested against the others.
+        for (auto& candidate : candidates) {
+            candidate.position.x += 0.25f;
+            if (candidate.position.x >= screen.x) {
+                candidate.position.x -= screen.x;
+            }
+        }
+        
+        clock.restart();
+        const std::vector<uint8_t>& anchors = placer.place(candidates, bounds);
+        sf::Time placed = clock.getElapsedTime();
+        
+        if (i >= 0) {
+            placeTime += placed;
+            shown += std::count_if(anchors.begin(), anchors.end(),
+                                   [](uint8_t anchor) { return anchor != LabelPlacer::HIDDEN; });
+        }
+    }
+    
+    result.ms = placeTime.asMicroseconds() / 1000.0 / frames;
+    result.shown = static_cast<double>(shown) / frames;
+    return result;
+}
+
+std::string toJson(const std::vector<StateResult>& results, const PlacementResult& placement, int frames) {
+    std::ostringstream json;
+    json << "{\n  \"frames\": " << frames << ",\n  \"states\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        json << "    {\"state\": \"" << r.name << "\""
+             << ", \"ms_per_frame\": " << r.recordMs + r.submitMs
+             << ", \"record_ms\": " << r.recordMs
+             << ", \"submit_ms\": " << r.submitMs
+             << ", \"allocations_per_frame\": " << r.allocationsPerFrame
+             << ", \"draw_calls\": " << r.drawCalls
+             << ", \"text_objects\": " << r.textObjects << "}"
+             << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    json << "  ],\n  \"label_placement\": {\"labels\": " << PLACEMENT_LABELS
+         << ", \"ms_per_frame\": " << placement.ms
+         << ", \"shown\": " << placement.shown << "}\n}\n";
+    return json.str();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int frames = argc >= 2 ? std::max(1, std::atoi(argv[1])) : 300;
+    std::string outputPath = argc >= 3 ? argv[2] : "render_bench.json";
+    
+    sf::RenderTexture target;
+    if (!target.create(1024, 768)) {
+        std::cerr << "Cannot create offscreen render target" << std::endl;
+        return 1;
+    }
+    target.setActive(true);
+    
+    Game game(false);
+    if (!game.initContent(BENCH_SEED)) {
+        std::cerr << "Cannot initialize game content" << std::endl;
+        return 1;
+    }
+    
+    ResourceCache& cache = ResourceCache::getInstance();
+    while (cache.getPendingCount() > 0) {
+        cache.pump();
+        sf::sleep(sf::milliseconds(1));
+    }
+    cache.pump();
+    
+    seedGame(game);
+    
+    std::vector<StateResult> results;
+    for (auto state : {Game::GameState::LOGIN, Game::GameState::MAIN_MENU, Game::GameState::SOLAR_SYSTEM,
+                       Game::GameState::QUIZ, Game::GameState::PLANET_INFO, Game::GameState::ACHIEVEMENTS,
+                       Game::GameState::STATISTICS}) {
+        results.push_back(measureState(game, state, target, frames));
+    }
+    
+    PlacementResult placement = measureLabelPlacement(frames);
+    
+    // Nothing from the benchmark session should be saved.
+    game.getPlayer().reset();
+    
+    std::ofstream output(outputPath);
+    if (!output.is_open()) {
+        std::cerr << "Cannot write " << outputPath << std::endl;
+        return 1;
+    }
+    output << toJson(results, placement, frames);
+    
+    for (const auto& r : results) {
+        std::cout << r.name << ": " << r.recordMs + r.submitMs << " ms/frame, "
+                  << r.allocationsPerFrame << " allocations/frame" << std::endl;
+    }
+    std::cout << "Label placement: " << placement.ms << " ms/frame for " << PLACEMENT_LABELS
+              << " labels, " << placement.shown << " shown" << std::endl;
+    std::cout << "Results written to " << outputPath << std::endl;
+    return 0;
+}
@@ -4,7 +4,8 @@ CREATE TABLE IF NOT EXISTS players (
     total_score INTEGER DEFAULT 0,
     quizzes_completed INTEGER DEFAULT 0,
     created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
-    last_played TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+    last_played TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+    version BIGINT NOT NULL DEFAULT 0
 );
 
 CREATE TABLE IF NOT EXISTS achievements (
@@ -21,11 +22,37 @@ CREATE TABLE IF NOT EXISTS quiz_results (
     correct_answers INTEGER NOT NULL,
     total_questions INTEGER NOT NULL,
     category VARCHAR(50),
+    completed_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+    time_spent INTEGER NOT NULL DEFAULT 0,
     FOREIGN KEY (name) REFERENCES players(name) ON DELETE CASCADE
 );
 
+CREATE TABLE IF NOT EXISTS quiz_result_summaries (
+    name VARCHAR(50) NOT NULL,
+    term VARCHAR(20) NOT NULL,
+    quizzes_archived INTEGER NOT NULL DEFAULT 0,
+    total_score INTEGER NOT NULL DEFAULT 0,
+    correct_answers INTEGER NOT NULL DEFAULT 0,
+    total_questions INTEGER NOT NULL DEFAULT 0,
+    archive_file VARCHAR(256) NOT NULL,
+    archived_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+    PRIMARY KEY (name, term),
+    FOREIGN KEY (name) REFERENCES players(name) ON DELETE CASCADE
+);
+
+CREATE TABLE IF NOT EXISTS quiz_sketches (
+    day DATE NOT NULL,
+    category VARCHAR(50) NOT NULL,
+    quiz_count INTEGER NOT NULL DEFAULT 0,
+    players_hll BYTEA NOT NULL DEFAULT '',
+    score_digest BYTEA NOT NULL DEFAULT '',
+    time_digest BYTEA NOT NULL DEFAULT '',
+    PRIMARY KEY (day, category)
+);
+
 CREATE INDEX IF NOT EXISTS idx_players_score ON players(total_score DESC);
 CREATE INDEX IF NOT EXISTS idx_quiz_results_name ON quiz_results(name);
+CREATE INDEX IF NOT EXISTS idx_quiz_results_completed_at ON quiz_results(completed_at);
 CREATE INDEX IF NOT EXISTS idx_achievements_name ON achievements(name);
 
 SELECT 'База данных AstroLearn инициализирована успешно!' as message;
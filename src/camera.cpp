@@ -0,0 +1,121 @@
+#include "camera.h"
+#include <algorithm>
+#include <cmath>
+
+Camera::Camera(const sf::Vector2f& screenSize)
+    : screenSize(screenSize) {
+    reset();
+}
+
+void Camera::reset() {
+    center = targetCenter = sf::Vector2f(0.0f, 0.0f);
+    zoom = targetZoom = 1.0f;
+    anchored = false;
+    dragging = false;
+    dragged = false;
+    following = false;
+}
+
+void Camera::zoomAt(float factor, const sf::Vector2i& pixel) {
+    float oldTarget = targetZoom;
+    targetZoom = std::max(MIN_ZOOM, std::min(targetZoom * factor, MAX_ZOOM));
+    if (following || targetZoom == oldTarget) {
+        return;
+    }
+    
+    // The point under the cursor as currently drawn, so a new wheel step
+    // in the middle of an animation does not jump.
+    anchorPixel = sf::Vector2f(static_cast<float>(pixel.x), static_cast<float>(pixel.y));
+    anchorWorld = center + (anchorPixel - screenSize / 2.0f) / zoom;
+    anchored = true;
+    targetCenter = centerFor(anchorWorld, anchorPixel, targetZoom);
+}
+
+void Camera::beginDrag(const sf::Vector2i& pixel) {
+    dragging = true;
+    dragged = false;
+    dragStart = pixel;
+    dragWorld = screenToWorld(pixel);
+}
+
+void Camera::dragTo(const sf::Vector2i& pixel) {
+    if (!dragging) {
+        return;
+    }
+    
+    if (!dragged && std::abs(pixel.x - dragStart.x) + std::abs(pixel.y - dragStart.y) < DRAG_THRESHOLD) {
+        return;
+    }
+    
+    dragged = true;
+    following = false;
+    anchored = false;
+    targetZoom = zoom;
+    sf::Vector2f pixelPosition(static_cast<float>(pixel.x), static_cast<float>(pixel.y));
+    center = targetCenter = centerFor(dragWorld, pixelPosition, zoom);
+}
+
+bool Camera::endDrag() {
+    dragging = false;
+    return dragged;
+}
+
+void Camera::track(const sf::Vector2f& worldPosition) {
+    if (following) {
+        targetCenter = worldPosition;
+    }
+}
+
+void Camera::update(float deltaTime) {
+    float blend = 1.0f - std::exp(-EASE_RATE * deltaTime);
+    
+    // Zoom eases in log space so zooming in and out feel the same.
+    if (std::abs(targetZoom - zoom) < zoom * 0.001f) {
+        zoom = targetZoom;
+    } else {
+        zoom *= std::pow(targetZoom / zoom, blend);
+    }
+    
+    if (anchored) {
+        center = centerFor(anchorWorld, anchorPixel, zoom);
+        if (zoom == targetZoom) {
+            center = targetCenter;
+            anchored = false;
+        }
+        return;
+    }
+    
+    sf::Vector2f remaining = targetCenter - center;
+    if (std::abs(remaining.x) * zoom < 0.1f && std::abs(remaining.y) * zoom < 0.1f) {
+        center = targetCenter;
+    } else {
+        center += remaining * blend;
+    }
+}
+
+bool Camera::isMoving() const {
+    return zoom != targetZoom || center != targetCenter;
+}
+
+sf::View Camera::getView() const {
+    return sf::View(center, screenSize / zoom);
+}
+
+sf::FloatRect Camera::getVisibleRect() const {
+    sf::Vector2f size = screenSize / zoom;
+    return sf::FloatRect(center - size / 2.0f, size);
+}
+
+sf::Vector2f Camera::screenToWorld(const sf::Vector2i& pixel) const {
+    sf::Vector2f normalized(2.0f * pixel.x / screenSize.x - 1.0f, 1.0f - 2.0f * pixel.y / screenSize.y);
+    return getView().getInverseTransform().transformPoint(normalized);
+}
+
+sf::Vector2f Camera::worldToScreen(const sf::Vector2f& world) const {
+    sf::Vector2f normalized = getView().getTransform().transformPoint(world);
+    return sf::Vector2f((normalized.x + 1.0f) * screenSize.x / 2.0f, (1.0f - normalized.y) * screenSize.y / 2.0f);
+}
+
+sf::Vector2f Camera::centerFor(const sf::Vector2f& world, const sf::Vector2f& pixel, float atZoom) const {
+    return world - (pixel - screenSize / 2.0f) / atZoom;
+}
@@ -0,0 +1,70 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <SFML/Graphics.hpp>
+
+// World camera for the solar system, expressed as an sf::View so world
+// geometry stays as built and the GPU applies pan and zoom. Zoom is in
+// screen pixels per world unit. Zooming keeps the world point under the
+// cursor in place, dragging moves the world with the cursor, and while
+// following, the camera centres on whatever position track() reports.
+// Changes ease in over a few frames.
+class Camera {
+public:
+    explicit Camera(const sf::Vector2f& screenSize);
+    
+    // Multiplies the zoom by factor around the given screen pixel.
+    void zoomAt(float factor, const sf::Vector2i& pixel);
+    
+    void beginDrag(const sf::Vector2i& pixel);
+    void dragTo(const sf::Vector2i& pixel);
+    // True if the cursor moved far enough for the press to count as a drag.
+    bool endDrag();
+    bool isDragging() const { return dragging; }
+    
+    void follow() { following = true; anchored = false; }
+    void stopFollowing() { following = false; }
+    bool isFollowing() const { return following; }
+    void track(const sf::Vector2f& worldPosition);
+    
+    void reset();
+    void update(float deltaTime);
+    bool isMoving() const;
+    
+    sf::View getView() const;
+    float getZoom() const { return zoom; }
+    sf::Vector2f getCenter() const { return center; }
+    sf::FloatRect getVisibleRect() const;
+    
+    // Both go through the view's transform, so picking matches drawing.
+    sf::Vector2f screenToWorld(const sf::Vector2i& pixel) const;
+    sf::Vector2f worldToScreen(const sf::Vector2f& world) const;
+    
+    static constexpr float MIN_ZOOM = 0.25f;
+    static constexpr float MAX_ZOOM = 40.0f;
+    static constexpr float EASE_RATE = 12.0f;
+    static constexpr int DRAG_THRESHOLD = 4;
+
+private:
+    sf::Vector2f screenSize;
+    sf::Vector2f center;
+    sf::Vector2f targetCenter;
+    float zoom;
+    float targetZoom;
+    
+    // While zooming, the world point that stays under anchorPixel.
+    bool anchored;
+    sf::Vector2f anchorWorld;
+    sf::Vector2f anchorPixel;
+    
+    bool dragging;
+    bool dragged;
+    sf::Vector2i dragStart;
+    sf::Vector2f dragWorld;
+    
+    bool following;
+    
+    sf::Vector2f centerFor(const sf::Vector2f& world, const sf::Vector2f& pixel, float atZoom) const;
+};
+
+#endif
@@ -1,7 +1,8 @@
 #include "celestial_body.h"
+#include "resource_cache.h"
 #include <iostream>
 #include <cmath>
-#include <vector>
+#include <algorithm>
 
 CelestialBody::CelestialBody(const std::string& name, Type type, float radius, 
                            float orbitRadius, float orbitSpeed, const sf::Color& color,
@@ -12,21 +13,15 @@ CelestialBody::CelestialBody(const std::string& name, Type type, float radius,
     , orbitRadius(orbitRadius)
     , orbitSpeed(orbitSpeed)
     , currentAngle(0.0f)
+    , previousAngle(0.0f)
     , color(color)
     , isSelected(false) {
     
     initGraphics();
     
+    shape.setFillColor(color);
     if (!texturePath.empty()) {
-        texture = std::make_shared<sf::Texture>();
-        if (texture->loadFromFile(texturePath)) {
-            shape.setTexture(texture.get());
-        } else {
-            std::cerr << "Failed to load texture: " << texturePath << std::endl;
-            shape.setFillColor(color);
-        }
-    } else {
-        shape.setFillColor(color);
+        texture = ResourceCache::getInstance().loadTexture(texturePath);
     }
 }
 
@@ -34,102 +29,112 @@ void CelestialBody::initGraphics() {
     shape.setRadius(radius);
     shape.setOrigin(radius, radius);
     shape.setOutlineThickness(2);
-    
-    if (orbitRadius > 0) {
-        orbitCircle.setRadius(orbitRadius);
-        orbitCircle.setOrigin(orbitRadius, orbitRadius);
-        orbitCircle.setFillColor(sf::Color::Transparent);
-        orbitCircle.setOutlineColor(sf::Color(100, 100, 100, 100));
-        orbitCircle.setOutlineThickness(1);
-    }
 }
 
 void CelestialBody::update(float deltaTime) {
+    previousAngle = currentAngle;
     if (orbitRadius > 0) {
-        currentAngle += orbitSpeed * deltaTime;
-        if (currentAngle >= 360.0f) {
-            currentAngle -= 360.0f;
-        }
+        currentAngle = std::fmod(currentAngle + orbitSpeed * deltaTime, 360.0f);
     }
 }
 
-void CelestialBody::draw(sf::RenderWindow& window, float centerX, float centerY) {
-    if (orbitRadius > 0) {
-        orbitCircle.setPosition(centerX, centerY);
-        window.draw(orbitCircle);
+void CelestialBody::place(float alpha) {
+    float delta = currentAngle - previousAngle;
+    if (delta < 0.0f) {
+        delta += 360.0f;
     }
+    float angleRad = (previousAngle + delta * alpha) * 3.14159265f / 180.0f;
+    shape.setPosition(orbitRadius * std::cos(angleRad), orbitRadius * std::sin(angleRad));
+}
+
+float CelestialBody::getBoundingRadius() const {
+    if (!isSelected) {
+        return radius;
+    }
+    return type == Type::STAR ? radius * 1.5f : radius + shape.getOutlineThickness();
+}
+
+void CelestialBody::draw(DrawList& frame, float unitsPerPixel) {
+    sf::Vector2f position = shape.getPosition();
     
-    float angleRad = currentAngle * 3.14159265f / 180.0f;
-    float x = centerX + orbitRadius * std::cos(angleRad);
-    float y = centerY + orbitRadius * std::sin(angleRad);
-    
-    shape.setPosition(x, y);
+    if (!textureApplied && texture.isReady()) {
+        shape.setTexture(texture.getTexture());
+        shape.setTextureRect(texture.getRect());
+        shape.setFillColor(sf::Color::White);
+        textureApplied = true;
+    }
     
     if (isSelected) {
         shape.setOutlineColor(sf::Color::Yellow);
-        shape.setOutlineThickness(4);
+        shape.setOutlineThickness(4 * unitsPerPixel);
         
         if (type == Type::STAR) {
             sf::CircleShape glow(radius * 1.5f);
             glow.setOrigin(radius * 1.5f, radius * 1.5f);
-            glow.setPosition(x, y);
+            glow.setPosition(position);
             glow.setFillColor(sf::Color(color.r, color.g, color.b, 100));
-            window.draw(glow);
+            frame.draw(glow);
         }
     } else {
         shape.setOutlineColor(sf::Color::Transparent);
     }
     
-    window.draw(shape);
+    frame.draw(shape);
+}
+
+void CelestialBody::drawLabel(DrawList& frame, const sf::Vector2f& center) {
+    if (!labelFont || name.empty()) {
+        return;
+    }
     
-    if (!name.empty()) {
-        static sf::Font font;
-        static bool fontLoaded = false;
-        
-        if (!fontLoaded) {
-            std::vector<std::string> fontPaths = {
-                "resources/fonts/Ubuntu-R.ttf",
-                "resources/fonts/DejaVuSans.ttf",
-                "/usr/share/fonts/truetype/ubuntu/Ubuntu-R.ttf",
-                "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
-                "/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf",
-            };
-            
-            for (const auto& fontPath : fontPaths) {
-                if (font.loadFromFile(fontPath)) {
-                    fontLoaded = true;
-                    std::cout << "Font loaded from: " << fontPath << std::endl;
-                    break;
-                }
-            }
-            
-            if (!fontLoaded) {
-                std::cerr << "Warning: Could not load any font for celestial body labels." << std::endl;
-                sf::Text tempText;
-                font = *tempText.getFont();
-                fontLoaded = true;
-            }
-        }
-        
-        if (fontLoaded) {
-            sf::Text label;
-            label.setFont(font);
-            label.setString(name);
-            label.setCharacterSize(16);
-            label.setFillColor(isSelected ? sf::Color::Yellow : sf::Color::White);
-            
-            sf::FloatRect bounds = label.getLocalBounds();
-            label.setOrigin(bounds.width / 2, bounds.height);
-            label.setPosition(x, y - radius - 10);
-            
-            sf::Text shadow = label;
-            shadow.setFillColor(sf::Color(0, 0, 0, 150));
-            shadow.move(1, 1);
-            window.draw(shadow);
-            
-            window.draw(label);
-        }
+    if (labelDirty) {
+        updateLabel();
+    }
+    
+    label.setPosition(center);
+    labelShadow.setPosition(center.x + 1, center.y + 1);
+    frame.draw(labelShadow);
+    frame.draw(label);
+}
+
+sf::Vector2f CelestialBody::getLabelSize() {
+    if (!labelFont || name.empty()) {
+        return sf::Vector2f(0, 0);
+    }
+    
+    if (labelDirty) {
+        updateLabel();
     }
+    
+    sf::FloatRect bounds = label.getLocalBounds();
+    return sf::Vector2f(bounds.width, bounds.height);
+}
+
+void CelestialBody::setSelected(bool selected) {
+    if (isSelected != selected) {
+        isSelected = selected;
+        labelDirty = true;
+    }
+}
+
+void CelestialBody::setLabelFont(const sf::Font* font) {
+    labelFont = font;
+    labelDirty = true;
+}
+
+void CelestialBody::updateLabel() {
+    label.setFont(*labelFont);
+    label.setString(name);
+    label.setCharacterSize(16);
+    label.setFillColor(isSelected ? sf::Color::Yellow : sf::Color::White);
+    
+    sf::FloatRect bounds = label.getLocalBounds();
+    label.setOrigin(bounds.left + bounds.width / 2, bounds.top + bounds.height / 2);
+    
+    labelShadow = label;
+    labelShadow.setFillColor(sf::Color(0, 0, 0, 150));
+    
+    labelDirty = false;
 }
 
 sf::Vector2f CelestialBody::getPosition() const {
@@ -179,16 +184,15 @@ std::string CelestialBody::getDescription() const {
     return desc;
 }
 
-bool CelestialBody::contains(float x, float y, float centerX, float centerY) const {
-    sf::Vector2f pos = getPosition();
-    pos.x += centerX;
-    pos.y += centerY;
+bool CelestialBody::contains(float x, float y, float minRadius) const {
+    sf::Vector2f pos = shape.getPosition();
     
     float dx = x - pos.x;
     float dy = y - pos.y;
     float distanceSquared = dx * dx + dy * dy;
+    float pickRadius = std::max(radius, minRadius);
     
-    return distanceSquared <= (radius * radius);
+    return distanceSquared <= (pickRadius * pickRadius);
 }
 
 CelestialBody::PhysicalInfo CelestialBody::getPhysicalInfo() const {
@@ -4,6 +4,8 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 #include <memory>
+#include "resource_cache.h"
+#include "draw_list.h"
 
 class CelestialBody {
 public:
@@ -29,9 +31,25 @@ public:
     
     void update(float deltaTime);
     
-    void draw(sf::RenderWindow& window, float centerX, float centerY);
+    // Positions the body for this frame in world coordinates, with the Sun
+    // at the origin; alpha blends between the previous and current
+    // simulation step.
+    void place(float alpha = 1.0f);
+    // At the position of the last place(); unitsPerPixel keeps the
+    // selection outline the same width at any zoom.
+    void draw(DrawList& frame, float unitsPerPixel);
+    // Centred on center, which comes from label placement.
+    void drawLabel(DrawList& frame, const sf::Vector2f& center);
+    // Zero without a font or a name.
+    sf::Vector2f getLabelSize();
+    
+    sf::Vector2f getDisplayPosition() const { return shape.getPosition(); }
+    float getDisplayRadius() const { return radius; }
+    // Includes the selection outline and the glow of a selected star.
+    float getBoundingRadius() const;
     
     std::string getName() const { return name; }
+    const sf::Color& getColor() const { return color; }
     Type getType() const { return type; }
     float getRadius() const { return radius; }
     float getOrbitRadius() const { return orbitRadius; }
@@ -39,10 +57,16 @@ public:
     std::string getTypeString() const;
     std::string getDescription() const;
     
-    void setSelected(bool selected) { isSelected = selected; }
+    void setSelected(bool selected);
     bool getSelected() const { return isSelected; }
     
-    bool contains(float x, float y, float centerX, float centerY) const;
+    // Against the last placed position; minRadius keeps tiny bodies
+    // clickable when zoomed out.
+    bool contains(float x, float y, float minRadius) const;
+    
+    // The font is shared and must outlive the body; labels are laid out
+    // again only when the name or the selection changes.
+    void setLabelFont(const sf::Font* font);
     
     struct PhysicalInfo {
         float mass;
@@ -62,14 +86,21 @@ private:
     float orbitRadius;
     float orbitSpeed;
     float currentAngle;
+    float previousAngle;
     sf::Color color;
     bool isSelected = false;
     
-    std::shared_ptr<sf::Texture> texture;
+    ResourceCache::TextureHandle texture;
+    bool textureApplied = false;
     sf::CircleShape shape;
-    sf::CircleShape orbitCircle;
+    
+    const sf::Font* labelFont = nullptr;
+    sf::Text label;
+    sf::Text labelShadow;
+    bool labelDirty = true;
     
     void initGraphics();
+    void updateLabel();
     
     static sf::Color getDefaultColor(Type type);
 };
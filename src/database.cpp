@@ -1,16 +1,29 @@
 #include "database.h"
+#include "quiz_archive.h"
+#include "profile_cache.h"
+#include "quiz_sketch.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <random>
 #include <chrono>
 #include <functional>
+#include <map>
+#include <cmath>
+#include <thread>
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
 
 Database& Database::getInstance() {
     static Database instance;
     return instance;
 }
 
+Database::Database()
+    : profileCache(std::make_unique<ProfileCache>()) {
+}
+
 Database::~Database() {
     disconnect();
 }
@@ -22,7 +35,11 @@ bool Database::connect(const std::string& connString) {
         
         if (connection->is_open()) {
             std::cout << "Successfully connected to database: " << connection->dbname() << std::endl;
-            return initializeTables();
+            if (!initializeTables()) {
+                return false;
+            }
+            connected = true;
+            return true;
         } else {
             std::cerr << "Failed to connect to database" << std::endl;
             return false;
@@ -33,12 +50,48 @@ bool Database::connect(const std::string& connString) {
     }
 }
 
+void Database::connectInBackground(const std::string& connString, int retryIntervalMs) {
+    if (connected || connecting) {
+        return;
+    }
+    
+    if (connectThread.joinable()) {
+        connectThread.join();
+    }
+    
+    stopConnecting = false;
+    connecting = true;
+    
+    connectThread = std::thread([this, connString, retryIntervalMs]() {
+        while (!stopConnecting) {
+            if (connect(connString)) {
+                break;
+            }
+            connection.reset();
+            
+            std::cout << "Database not available yet, retrying in "
+                      << retryIntervalMs << " ms" << std::endl;
+            for (int waited = 0; waited < retryIntervalMs && !stopConnecting; waited += 100) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+        connecting = false;
+    });
+}
+
 void Database::disconnect() {
+    stopConnecting = true;
+    if (connectThread.joinable()) {
+        connectThread.join();
+    }
+    
+    connected = false;
     if (connection && connection->is_open()) {
         connection.reset();
         std::cout << "Database connection closed" << std::endl;
     }
     connection.reset();
+    profileCache->clear();
 }
 
 bool Database::initializeTables() {
@@ -52,10 +105,13 @@ bool Database::initializeTables() {
             "total_score INTEGER DEFAULT 0,"
             "quizzes_completed INTEGER DEFAULT 0,"
             "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
-            "last_played TIMESTAMP DEFAULT CURRENT_TIMESTAMP"
+            "last_played TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
+            "version BIGINT NOT NULL DEFAULT 0"
             ")"
         );
         
+        txn.exec("ALTER TABLE players ADD COLUMN IF NOT EXISTS version BIGINT NOT NULL DEFAULT 0");
+        
         txn.exec(
             "CREATE TABLE IF NOT EXISTS achievements ("
             "name VARCHAR(50) NOT NULL,"
@@ -73,12 +129,45 @@ bool Database::initializeTables() {
             "correct_answers INTEGER NOT NULL,"
             "total_questions INTEGER NOT NULL,"
             "category VARCHAR(50),"
+            "completed_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
+            "time_spent INTEGER NOT NULL DEFAULT 0,"
             "FOREIGN KEY (name) REFERENCES players(name) ON DELETE CASCADE"
             ")"
         );
+        
+        txn.exec("ALTER TABLE quiz_results ADD COLUMN IF NOT EXISTS completed_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP");
+        txn.exec("ALTER TABLE quiz_results ADD COLUMN IF NOT EXISTS time_spent INTEGER NOT NULL DEFAULT 0");
+        
+        txn.exec(
+            "CREATE TABLE IF NOT EXISTS quiz_result_summaries ("
+            "name VARCHAR(50) NOT NULL,"
+            "term VARCHAR(20) NOT NULL,"
+            "quizzes_archived INTEGER NOT NULL DEFAULT 0,"
+            "total_score INTEGER NOT NULL DEFAULT 0,"
+            "correct_answers INTEGER NOT NULL DEFAULT 0,"
+            "total_questions INTEGER NOT NULL DEFAULT 0,"
+            "archive_file VARCHAR(256) NOT NULL,"
+            "archived_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
+            "PRIMARY KEY (name, term),"
+            "FOREIGN KEY (name) REFERENCES players(name) ON DELETE CASCADE"
+            ")"
+        );
+        
+        txn.exec(
+            "CREATE TABLE IF NOT EXISTS quiz_sketches ("
+            "day DATE NOT NULL,"
+            "category VARCHAR(50) NOT NULL,"
+            "quiz_count INTEGER NOT NULL DEFAULT 0,"
+            "players_hll BYTEA NOT NULL DEFAULT '',"
+            "score_digest BYTEA NOT NULL DEFAULT '',"
+            "time_digest BYTEA NOT NULL DEFAULT '',"
+            "PRIMARY KEY (day, category)"
+            ")"
+        );
                 
         txn.exec("CREATE INDEX IF NOT EXISTS idx_players_score ON players(total_score DESC)");
         txn.exec("CREATE INDEX IF NOT EXISTS idx_quiz_results_player_name ON quiz_results(name)");
+        txn.exec("CREATE INDEX IF NOT EXISTS idx_quiz_results_completed_at ON quiz_results(completed_at)");
         txn.exec("CREATE INDEX IF NOT EXISTS idx_achievements_player_name ON achievements(name)");
         
         txn.commit();
@@ -176,13 +265,17 @@ int Database::createPlayer(const std::string& name, const std::string& password)
             return -2;
         }
         
-        txn.exec_params(
-            "INSERT INTO players (name, password_hash) VALUES ($1, $2)",
+        auto inserted = txn.exec_params(
+            "INSERT INTO players (name, password_hash) VALUES ($1, $2) "
+            "RETURNING name, password_hash, total_score, "
+            "quizzes_completed, created_at, last_played, version",
             name, password_hash
         );
         
         txn.commit();
         
+        profileCache->store({playerFromRow(inserted[0]), {}});
+        
         std::cout << "Created new player: " << name << std::endl;
         return 1;
         
@@ -194,30 +287,17 @@ int Database::createPlayer(const std::string& name, const std::string& password)
 
 Database::PlayerData Database::authenticatePlayer(const std::string& name, const std::string& password) {
     try {
-        pqxx::work txn(*connection);
+        PlayerData player = getPlayerProfile(name).player;
         
-        auto result = txn.exec_params(
-            "SELECT name, password_hash, total_score, "
-            "quizzes_completed, created_at, last_played "
-            "FROM players WHERE name = $1",
-            name
-        );
-        
-        if (result.empty()) {
-            throw std::runtime_error("Player not found with name: " + name);
-        }
-        
-        std::string stored_hash = result[0]["password_hash"].as<std::string>();
-        
-        if (stored_hash.empty()) {
+        if (player.password_hash.empty()) {
             throw std::runtime_error("Player account has no password set");
         }
         
-        if (!verifyPassword(password, stored_hash)) {
+        if (!verifyPassword(password, player.password_hash)) {
             throw std::runtime_error("Invalid password for player: " + name);
         }
         
-        return playerFromRow(result[0]);
+        return player;
         
     } catch (const std::exception& e) {
         std::cerr << "Failed to authenticate player: " << e.what() << std::endl;
@@ -231,12 +311,18 @@ bool Database::updatePassword(const std::string& playerName, const std::string&
         
         std::string password_hash = hashPassword(newPassword);
         
-        txn.exec_params(
-            "UPDATE players SET password_hash = $1 WHERE name = $2",
+        auto updated = txn.exec_params(
+            "UPDATE players SET password_hash = $1, version = version + 1 WHERE name = $2 "
+            "RETURNING name, password_hash, total_score, "
+            "quizzes_completed, created_at, last_played, version",
             password_hash, playerName
         );
         
         txn.commit();
+        
+        if (!updated.empty()) {
+            profileCache->updatePlayer(playerFromRow(updated[0]));
+        }
         std::cout << "Password updated for player: " << playerName << std::endl;
         return true;
         
@@ -250,18 +336,25 @@ bool Database::updatePlayer(const PlayerData& player) {
     try {
         pqxx::work txn(*connection);
         
-        txn.exec_params(
+        auto updated = txn.exec_params(
             "UPDATE players SET "
             "total_score = $1, "
             "quizzes_completed = $2, "
-            "last_played = CURRENT_TIMESTAMP "
-            "WHERE name = $3",
+            "last_played = CURRENT_TIMESTAMP, "
+            "version = version + 1 "
+            "WHERE name = $3 "
+            "RETURNING name, password_hash, total_score, "
+            "quizzes_completed, created_at, last_played, version",
             player.totalScore,
             player.quizzesCompleted,
             player.name
         );
         
         txn.commit();
+        
+        if (!updated.empty()) {
+            profileCache->updatePlayer(playerFromRow(updated[0]));
+        }
         std::cout << "Updated player: " << player.name << std::endl;
         return true;
         
@@ -272,12 +365,27 @@ bool Database::updatePlayer(const PlayerData& player) {
 }
 
 Database::PlayerData Database::getPlayerByName(const std::string& name) {
+    return getPlayerProfile(name).player;
+}
+
+Database::PlayerProfile Database::getPlayerProfile(const std::string& name) {
+    PlayerProfile profile;
+    if (profileCache->lookup(name, profile)) {
+        // Another client may have changed the row since it was cached. Any
+        // write bumps the version, so one version read is enough to tell.
+        if (!connection || !connection->is_open() || isProfileCurrent(name, profile.player.version)) {
+            return profile;
+        }
+        profileCache->erase(name);
+        profile = PlayerProfile();
+    }
+    
     try {
         pqxx::work txn(*connection);
         
         auto result = txn.exec_params(
             "SELECT name, password_hash, total_score, "
-            "quizzes_completed, created_at, last_played "
+            "quizzes_completed, created_at, last_played, version "
             "FROM players WHERE name = $1",
             name
         );
@@ -286,7 +394,20 @@ Database::PlayerData Database::getPlayerByName(const std::string& name) {
             throw std::runtime_error("Player not found with name: " + name);
         }
         
-        return playerFromRow(result[0]);
+        profile.player = playerFromRow(result[0]);
+        
+        auto achievementRows = txn.exec_params(
+            "SELECT name, achievement_id, unlock_date "
+            "FROM achievements WHERE name = $1 ORDER BY unlock_date DESC",
+            name
+        );
+        
+        for (const auto& row : achievementRows) {
+            profile.achievements.push_back(achievementFromRow(row));
+        }
+        
+        profileCache->store(profile);
+        return profile;
         
     } catch (const std::exception& e) {
         std::cerr << "Failed to get player by name: " << e.what() << std::endl;
@@ -294,6 +415,67 @@ Database::PlayerData Database::getPlayerByName(const std::string& name) {
     }
 }
 
+int Database::revalidateProfileCache() {
+    if (!connection || !connection->is_open()) {
+        return -1;
+    }
+    
+    try {
+        pqxx::work txn(*connection);
+        
+        auto result = txn.exec("SELECT name, version FROM players");
+        
+        std::map<std::string, long long> versions;
+        for (const auto& row : result) {
+            versions[row["name"].as<std::string>()] = row["version"].as<long long>();
+        }
+        
+        int dropped = profileCache->dropStale(versions);
+        if (dropped > 0) {
+            std::cout << "Profile cache: dropped " << dropped << " stale entries" << std::endl;
+        }
+        return dropped;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to revalidate profile cache: " << e.what() << std::endl;
+        return -1;
+    }
+}
+
+bool Database::isProfileCurrent(const std::string& name, long long version) {
+    try {
+        pqxx::work txn(*connection);
+        
+        auto result = txn.exec_params("SELECT version FROM players WHERE name = $1", name);
+        return !result.empty() && result[0]["version"].as<long long>() == version;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to check cached profile: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool Database::isRosterCurrent(const std::vector<PlayerData>& players) {
+    // Versions only grow, so any write since the roster was cached changes
+    // the sum, and a new or removed player changes the count.
+    long long versionSum = 0;
+    for (const auto& player : players) {
+        versionSum += player.version;
+    }
+    
+    try {
+        pqxx::work txn(*connection);
+        
+        auto result = txn.exec("SELECT COUNT(*) AS players, COALESCE(SUM(version), 0) AS versions FROM players");
+        return result[0]["players"].as<long long>() == static_cast<long long>(players.size()) &&
+               result[0]["versions"].as<long long>() == versionSum;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to check cached roster: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 Database::PlayerData Database::playerFromRow(const pqxx::row& row) {
     PlayerData player;
     
@@ -301,6 +483,7 @@ Database::PlayerData Database::playerFromRow(const pqxx::row& row) {
     player.password_hash = row["password_hash"].as<std::string>();
     player.totalScore = row["total_score"].as<int>();
     player.quizzesCompleted = row["quizzes_completed"].as<int>();
+    player.version = row["version"].as<long long>();
     
     if (!row["created_at"].is_null()) {
         std::string createdStr = row["created_at"].as<std::string>();
@@ -322,12 +505,19 @@ Database::PlayerData Database::playerFromRow(const pqxx::row& row) {
 std::vector<Database::PlayerData> Database::getAllPlayers() {
     std::vector<PlayerData> players;
     
+    if (profileCache->lookupRoster(players)) {
+        if (!connection || !connection->is_open() || isRosterCurrent(players)) {
+            return players;
+        }
+        players.clear();
+    }
+    
     try {
         pqxx::work txn(*connection);
         
         auto result = txn.exec(
             "SELECT name, password_hash, total_score, "
-            "quizzes_completed, created_at, last_played "
+            "quizzes_completed, created_at, last_played, version "
             "FROM players ORDER BY total_score DESC"
         );
         
@@ -335,6 +525,8 @@ std::vector<Database::PlayerData> Database::getAllPlayers() {
             players.push_back(playerFromRow(row));
         }
         
+        profileCache->storeRoster(players);
+        
     } catch (const std::exception& e) {
         std::cerr << "Failed to get all players: " << e.what() << std::endl;
     }
@@ -355,7 +547,7 @@ std::vector<Database::PlayerData> Database::getTopPlayers(int limit) {
         
         auto result = txn.exec_params(
             "SELECT name, password_hash, total_score, "
-            "quizzes_completed, created_at, last_played "
+            "quizzes_completed, created_at, last_played, version "
             "FROM players ORDER BY total_score DESC LIMIT $1",
             limit
         );
@@ -389,7 +581,17 @@ bool Database::unlockAchievement(const std::string& playerName, const std::strin
             playerName, achievementId
         );
         
+        auto bumped = txn.exec_params(
+            "UPDATE players SET version = version + 1 WHERE name = $1 RETURNING version",
+            playerName
+        );
+        
         txn.commit();
+        
+        if (!bumped.empty()) {
+            profileCache->addAchievement({playerName, achievementId, std::time(nullptr)},
+                                         bumped[0]["version"].as<long long>());
+        }
         std::cout << "Achievement '" << achievementId << "' unlocked for " << playerName << std::endl;
         return true;
         
@@ -401,14 +603,12 @@ bool Database::unlockAchievement(const std::string& playerName, const std::strin
 
 bool Database::hasAchievement(const std::string& playerName, const std::string& achievementId) {
     try {
-        pqxx::work txn(*connection);
-        
-        auto result = txn.exec_params(
-            "SELECT name FROM achievements WHERE name = $1 AND achievement_id = $2",
-            playerName, achievementId
-        );
-        
-        return !result.empty();
+        for (const auto& achievement : getPlayerProfile(playerName).achievements) {
+            if (achievement.achievementId == achievementId) {
+                return true;
+            }
+        }
+        return false;
         
     } catch (const std::exception& e) {
         std::cerr << "Failed to check achievement: " << e.what() << std::endl;
@@ -436,18 +636,7 @@ std::vector<Database::AchievementData> Database::getPlayerAchievements(const std
     std::vector<AchievementData> achievements;
     
     try {
-        pqxx::work txn(*connection);
-        
-        auto result = txn.exec_params(
-            "SELECT name, achievement_id, unlock_date "
-            "FROM achievements WHERE name = $1 ORDER BY unlock_date DESC",
-            playerName
-        );
-        
-        for (const auto& row : result) {
-            achievements.push_back(achievementFromRow(row));
-        }
-        
+        achievements = getPlayerProfile(playerName).achievements;
     } catch (const std::exception& e) {
         std::cerr << "Failed to get player achievements: " << e.what() << std::endl;
     }
@@ -461,22 +650,33 @@ bool Database::saveQuizResult(const QuizResultData& result) {
         
         txn.exec_params(
             "INSERT INTO quiz_results (name, score, correct_answers, "
-            "total_questions, category) "
-            "VALUES ($1, $2, $3, $4, $5)",
+            "total_questions, category, completed_at, time_spent) "
+            "VALUES ($1, $2, $3, $4, $5, COALESCE(NULLIF($6, '')::timestamp, CURRENT_TIMESTAMP), $7)",
             result.playerName, result.score, result.correctAnswers,
-            result.totalQuestions, result.category
+            result.totalQuestions, result.category,
+            result.completedAt != 0 ? timeToString(result.completedAt) : std::string(),
+            result.timeSpent
         );
         
-        txn.exec_params(
+        updateQuizSketch(txn, result);
+        
+        auto updated = txn.exec_params(
             "UPDATE players SET "
             "quizzes_completed = quizzes_completed + 1, "
             "total_score = total_score + $1, "
-            "last_played = CURRENT_TIMESTAMP "
-            "WHERE name = $2",
+            "last_played = CURRENT_TIMESTAMP, "
+            "version = version + 1 "
+            "WHERE name = $2 "
+            "RETURNING name, password_hash, total_score, "
+            "quizzes_completed, created_at, last_played, version",
             result.score, result.playerName
         );
         
         txn.commit();
+        
+        if (!updated.empty()) {
+            profileCache->updatePlayer(playerFromRow(updated[0]));
+        }
         std::cout << "Quiz result saved for player " << result.playerName 
                   << " (Score: " << result.score << ")" << std::endl;
         
@@ -495,11 +695,63 @@ Database::QuizResultData Database::quizResultFromRow(const pqxx::row& row) {
     result.score = row["score"].as<int>();
     result.correctAnswers = row["correct_answers"].as<int>();
     result.totalQuestions = row["total_questions"].as<int>();
-    result.category = row["category"].as<std::string>();
+    result.category = row["category"].is_null() ? "" : row["category"].as<std::string>();
+    
+    if (!row["completed_at"].is_null()) {
+        result.completedAt = stringToTime(row["completed_at"].as<std::string>());
+    } else {
+        result.completedAt = std::time(nullptr);
+    }
+    result.timeSpent = row["time_spent"].as<int>();
     
     return result;
 }
 
+void Database::updateQuizSketch(pqxx::work& txn, const QuizResultData& result) {
+    // The day is worked out by the server, in the same time zone as the
+    // CURRENT_DATE that getGlobalStats() counts today by; the client's
+    // local date can be a different day.
+    auto dayRow = txn.exec_params(
+        "SELECT (CASE WHEN $1::bigint = 0 THEN CURRENT_DATE "
+        "ELSE to_timestamp($1::bigint)::date END)::text AS day",
+        static_cast<long long>(result.completedAt)
+    );
+    std::string day = dayRow[0]["day"].as<std::string>();
+    
+    txn.exec_params(
+        "INSERT INTO quiz_sketches (day, category) VALUES ($1::date, $2) "
+        "ON CONFLICT (day, category) DO NOTHING",
+        day, result.category
+    );
+    
+    auto existing = txn.exec_params(
+        "SELECT quiz_count, encode(players_hll, 'hex') AS players_hll, "
+        "encode(score_digest, 'hex') AS score_digest, encode(time_digest, 'hex') AS time_digest "
+        "FROM quiz_sketches WHERE day = $1::date AND category = $2 FOR UPDATE",
+        day, result.category
+    );
+    
+    QuizSketch sketch;
+    if (!existing.empty()) {
+        const auto& row = existing[0];
+        sketch.quizCount = row["quiz_count"].as<int>();
+        sketch.players = HyperLogLog::deserialize(QuizSketch::fromHex(row["players_hll"].as<std::string>()));
+        sketch.scores = TDigest::deserialize(QuizSketch::fromHex(row["score_digest"].as<std::string>()));
+        sketch.timesSpent = TDigest::deserialize(QuizSketch::fromHex(row["time_digest"].as<std::string>()));
+    }
+    sketch.add(result);
+    
+    txn.exec_params(
+        "UPDATE quiz_sketches SET quiz_count = $3, "
+        "players_hll = decode($4, 'hex'), score_digest = decode($5, 'hex'), time_digest = decode($6, 'hex') "
+        "WHERE day = $1::date AND category = $2",
+        day, result.category, sketch.quizCount,
+        QuizSketch::toHex(sketch.players.serialize()),
+        QuizSketch::toHex(sketch.scores.serialize()),
+        QuizSketch::toHex(sketch.timesSpent.serialize())
+    );
+}
+
 std::vector<Database::QuizResultData> Database::getPlayerQuizHistory(const std::string& playerName, int limit) {
     std::vector<QuizResultData> results;
     
@@ -508,7 +760,7 @@ std::vector<Database::QuizResultData> Database::getPlayerQuizHistory(const std::
         
         auto result = txn.exec_params(
             "SELECT name, score, correct_answers, total_questions, "
-            "accuracy, time_spent, category, completed_at "
+            "category, completed_at, time_spent "
             "FROM quiz_results WHERE name = $1 "
             "ORDER BY completed_at DESC LIMIT $2",
             playerName, limit
@@ -525,6 +777,170 @@ std::vector<Database::QuizResultData> Database::getPlayerQuizHistory(const std::
     return results;
 }
 
+int Database::archiveQuizResults(std::time_t cutoff, const std::string& archiveDir) {
+    if (!connection || !connection->is_open()) {
+        std::cerr << "Database not connected, cannot archive quiz results" << std::endl;
+        return -1;
+    }
+    
+    if (mkdir(archiveDir.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "Cannot create archive directory " << archiveDir << ": " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    
+    std::vector<std::string> writtenFiles;
+    
+    try {
+        pqxx::work txn(*connection);
+        
+        txn.exec("LOCK TABLE quiz_results IN SHARE ROW EXCLUSIVE MODE");
+        
+        std::string cutoffStr = timeToString(cutoff);
+        auto result = txn.exec_params(
+            "SELECT name, score, correct_answers, total_questions, "
+            "category, completed_at, time_spent "
+            "FROM quiz_results WHERE completed_at < $1::timestamp "
+            "ORDER BY name, completed_at",
+            cutoffStr
+        );
+        
+        if (result.empty()) {
+            std::cout << "No quiz results older than " << cutoffStr << " to archive" << std::endl;
+            return 0;
+        }
+        
+        std::map<std::string, std::vector<QuizResultData>> resultsByTerm;
+        for (const auto& row : result) {
+            QuizResultData data = quizResultFromRow(row);
+            resultsByTerm[QuizArchive::termForTime(data.completedAt)].push_back(data);
+        }
+        
+        for (const auto& [term, rows] : resultsByTerm) {
+            std::string path = QuizArchive::archivePath(archiveDir, term);
+            if (!QuizArchive::writeTerm(path, term, rows)) {
+                throw std::runtime_error("Could not write archive file for term " + term);
+            }
+            writtenFiles.push_back(path);
+            
+            for (const auto& summary : QuizArchive::summarize(rows)) {
+                txn.exec_params(
+                    "INSERT INTO quiz_result_summaries (name, term, quizzes_archived, "
+                    "total_score, correct_answers, total_questions, archive_file) "
+                    "VALUES ($1, $2, $3, $4, $5, $6, $7) "
+                    "ON CONFLICT (name, term) DO UPDATE SET "
+                    "quizzes_archived = quiz_result_summaries.quizzes_archived + EXCLUDED.quizzes_archived, "
+                    "total_score = quiz_result_summaries.total_score + EXCLUDED.total_score, "
+                    "correct_answers = quiz_result_summaries.correct_answers + EXCLUDED.correct_answers, "
+                    "total_questions = quiz_result_summaries.total_questions + EXCLUDED.total_questions, "
+                    "archive_file = EXCLUDED.archive_file, "
+                    "archived_at = CURRENT_TIMESTAMP",
+                    summary.playerName, term, summary.rowCount, summary.totalScore,
+                    summary.correctAnswers, summary.totalQuestions, path
+                );
+            }
+        }
+        
+        txn.exec_params(
+            "DELETE FROM quiz_results WHERE completed_at < $1::timestamp",
+            cutoffStr
+        );
+        
+        txn.commit();
+        
+        for (const auto& path : writtenFiles) {
+            QuizArchive::discardBackup(path);
+        }
+        
+        std::cout << "Archived " << result.size() << " quiz results older than " << cutoffStr
+                  << " into " << writtenFiles.size() << " term file(s)" << std::endl;
+        return static_cast<int>(result.size());
+        
+    } catch (const std::exception& e) {
+        for (const auto& path : writtenFiles) {
+            QuizArchive::restoreBackup(path);
+        }
+        std::cerr << "Failed to archive quiz results: " << e.what() << std::endl;
+        return -1;
+    }
+}
+
+std::vector<Database::QuizArchiveSummary> Database::getPlayerArchiveSummaries(const std::string& playerName) {
+    std::vector<QuizArchiveSummary> summaries;
+    
+    try {
+        pqxx::work txn(*connection);
+        
+        auto result = txn.exec_params(
+            "SELECT name, term, quizzes_archived, total_score, "
+            "correct_answers, total_questions, archive_file "
+            "FROM quiz_result_summaries WHERE name = $1 ORDER BY term",
+            playerName
+        );
+        
+        for (const auto& row : result) {
+            QuizArchiveSummary summary;
+            summary.playerName = row["name"].as<std::string>();
+            summary.term = row["term"].as<std::string>();
+            summary.quizzesArchived = row["quizzes_archived"].as<int>();
+            summary.totalScore = row["total_score"].as<int>();
+            summary.correctAnswers = row["correct_answers"].as<int>();
+            summary.totalQuestions = row["total_questions"].as<int>();
+            summary.archiveFile = row["archive_file"].as<std::string>();
+            summaries.push_back(summary);
+        }
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to get archive summaries: " << e.what() << std::endl;
+    }
+    
+    return summaries;
+}
+
+bool Database::streamPlayerQuizHistory(const std::string& playerName,
+                                       const std::function<void(const QuizResultData&)>& visitor) {
+    bool complete = true;
+    
+    for (const auto& summary : getPlayerArchiveSummaries(playerName)) {
+        if (!QuizArchive::forEachPlayerResult(summary.archiveFile, playerName, visitor)) {
+            std::cerr << "Archived history for term " << summary.term 
+                      << " is unavailable (" << summary.quizzesArchived << " results)" << std::endl;
+            complete = false;
+        }
+    }
+    
+    try {
+        pqxx::work txn(*connection);
+        
+        auto result = txn.exec_params(
+            "SELECT name, score, correct_answers, total_questions, "
+            "category, completed_at, time_spent "
+            "FROM quiz_results WHERE name = $1 "
+            "ORDER BY completed_at",
+            playerName
+        );
+        
+        for (const auto& row : result) {
+            visitor(quizResultFromRow(row));
+        }
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to stream quiz history: " << e.what() << std::endl;
+        return false;
+    }
+    
+    return complete;
+}
+
+std::vector<Database::QuizResultData> Database::getPlayerFullQuizHistory(const std::string& playerName) {
+    std::vector<QuizResultData> results;
+    
+    streamPlayerQuizHistory(playerName, [&results](const QuizResultData& result) {
+        results.push_back(result);
+    });
+    
+    return results;
+}
+
 Database::GlobalStats Database::getGlobalStats() {
     GlobalStats stats{};
     
@@ -544,9 +960,59 @@ Database::GlobalStats Database::getGlobalStats() {
             stats.totalQuizzesCompleted = row["total_quizzes"].as<int>();
         }
         
+        auto today = txn.exec(
+            "SELECT encode(players_hll, 'hex') AS players_hll "
+            "FROM quiz_sketches WHERE day = CURRENT_DATE"
+        );
+        
+        HyperLogLog players;
+        for (const auto& row : today) {
+            players.merge(HyperLogLog::deserialize(QuizSketch::fromHex(row["players_hll"].as<std::string>())));
+        }
+        stats.activePlayersToday = static_cast<int>(std::lround(players.estimate()));
+        
     } catch (const std::exception& e) {
         std::cerr << "Failed to get global stats: " << e.what() << std::endl;
     }
     
     return stats;
 }
+
+Database::QuizAnalytics Database::getQuizAnalytics(std::time_t from, std::time_t to, const std::string& category) {
+    QuizAnalytics analytics{};
+    
+    try {
+        pqxx::work txn(*connection);
+        
+        auto result = txn.exec_params(
+            "SELECT quiz_count, encode(players_hll, 'hex') AS players_hll, "
+            "encode(score_digest, 'hex') AS score_digest, encode(time_digest, 'hex') AS time_digest "
+            "FROM quiz_sketches "
+            "WHERE day BETWEEN to_timestamp($1::bigint)::date AND to_timestamp($2::bigint)::date "
+            "AND ($3 = '' OR category = $3)",
+            static_cast<long long>(from), static_cast<long long>(to), category
+        );
+        
+        QuizSketch total;
+        for (const auto& row : result) {
+            QuizSketch sketch;
+            sketch.quizCount = row["quiz_count"].as<int>();
+            sketch.players = HyperLogLog::deserialize(QuizSketch::fromHex(row["players_hll"].as<std::string>()));
+            sketch.scores = TDigest::deserialize(QuizSketch::fromHex(row["score_digest"].as<std::string>()));
+            sketch.timesSpent = TDigest::deserialize(QuizSketch::fromHex(row["time_digest"].as<std::string>()));
+            total.merge(sketch);
+        }
+        
+        analytics.quizCount = total.quizCount;
+        analytics.distinctPlayers = total.players.estimate();
+        analytics.medianScore = total.scores.quantile(0.5);
+        analytics.p90Score = total.scores.quantile(0.9);
+        analytics.medianTimeSpent = total.timesSpent.quantile(0.5);
+        analytics.p90TimeSpent = total.timesSpent.quantile(0.9);
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to get quiz analytics: " << e.what() << std::endl;
+    }
+    
+    return analytics;
+}
@@ -5,7 +5,12 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
 #include <ctime>
+#include <thread>
+#include <atomic>
+
+class ProfileCache;
 
 class Database {
 public:
@@ -16,6 +21,7 @@ public:
         int quizzesCompleted;
         std::time_t createdAt;
         std::time_t lastPlayed;
+        long long version = 0;
     };
     
     struct AchievementData {
@@ -24,23 +30,47 @@ public:
         std::time_t unlockDate;
     };
     
+    struct PlayerProfile {
+        PlayerData player;
+        std::vector<AchievementData> achievements;
+    };
+    
     struct QuizResultData {
         std::string playerName;
         int score;
         int correctAnswers;
         int totalQuestions;
         std::string category;
+        std::time_t completedAt = 0;
+        int timeSpent = 0;
+    };
+
+    struct QuizArchiveSummary {
+        std::string playerName;
+        std::string term;
+        int quizzesArchived;
+        int totalScore;
+        int correctAnswers;
+        int totalQuestions;
+        std::string archiveFile;
     };
-        
+
     static Database& getInstance();
     
     bool connect(const std::string& connString = "dbname=astrolearn user=postgres password=postgres host=localhost port=5432");
+    // Keeps retrying connect() on a worker thread until it succeeds;
+    // isConnected() flips to true once the tables are initialized.
+    void connectInBackground(const std::string& connString, int retryIntervalMs = 2000);
     void disconnect();
-    bool isConnected() const { return connection != nullptr; }
+    bool isConnected() const { return connected; }
+    bool isConnecting() const { return connecting; }
     
     int createPlayer(const std::string& name, const std::string& password);
     bool updatePlayer(const PlayerData& player);
     PlayerData getPlayerByName(const std::string& name);
+    PlayerProfile getPlayerProfile(const std::string& name);
+    int revalidateProfileCache();
+    ProfileCache& getProfileCache() { return *profileCache; }
     PlayerData authenticatePlayer(const std::string& name, const std::string& password);
     bool updatePassword(const std::string& playerName, const std::string& newPassword);
     std::vector<PlayerData> getAllPlayers();
@@ -52,32 +82,61 @@ public:
     
     bool saveQuizResult(const QuizResultData& result);
     std::vector<QuizResultData> getPlayerQuizHistory(const std::string& playerName, int limit = 20);
-        
+
+    int archiveQuizResults(std::time_t cutoff, const std::string& archiveDir = "archive");
+    std::vector<QuizArchiveSummary> getPlayerArchiveSummaries(const std::string& playerName);
+    bool streamPlayerQuizHistory(const std::string& playerName,
+                                 const std::function<void(const QuizResultData&)>& visitor);
+    std::vector<QuizResultData> getPlayerFullQuizHistory(const std::string& playerName);
+
     struct GlobalStats {
         int totalPlayers;
         int totalQuizzesCompleted;
+        int activePlayersToday;
+    };
+    
+    struct QuizAnalytics {
+        int quizCount;
+        double distinctPlayers;
+        double medianScore;
+        double p90Score;
+        double medianTimeSpent;
+        double p90TimeSpent;
     };
     
     GlobalStats getGlobalStats();
+    // Answered from the per-day sketches; an empty category means all categories.
+    QuizAnalytics getQuizAnalytics(std::time_t from, std::time_t to, const std::string& category = "");
     
     bool initializeTables();
     
 private:
-    Database() = default;
+    Database();
     ~Database();
     
     Database(const Database&) = delete;
     Database& operator=(const Database&) = delete;
     
     std::unique_ptr<pqxx::connection> connection;
+    std::unique_ptr<ProfileCache> profileCache;
+    
+    std::thread connectThread;
+    std::atomic<bool> connected{false};
+    std::atomic<bool> connecting{false};
+    std::atomic<bool> stopConnecting{false};
     
     std::string hashPassword(const std::string& password);
     bool verifyPassword(const std::string& password, const std::string& hash);
     
+    bool isProfileCurrent(const std::string& name, long long version);
+    bool isRosterCurrent(const std::vector<PlayerData>& players);
+    
     PlayerData playerFromRow(const pqxx::row& row);
     AchievementData achievementFromRow(const pqxx::row& row);
     QuizResultData quizResultFromRow(const pqxx::row& row);
     
+    void updateQuizSketch(pqxx::work& txn, const QuizResultData& result);
+    
     std::time_t stringToTime(const std::string& timeStr);
     std::string timeToString(std::time_t time);
 };
@@ -0,0 +1,53 @@
+#include "draw_list.h"
+
+std::atomic<size_t> DrawList::nextPoolIndex(0);
+
+void DrawList::reset() {
+    for (auto& pool : pools) {
+        if (pool) {
+            pool->used = 0;
+        }
+    }
+    commands.clear();
+    views.clear();
+    sceneEnd = 0;
+    textCount = 0;
+    textSizes.clear();
+    clearColor = sf::Color::Black;
+}
+
+void DrawList::noteTextSize(unsigned int characterSize, bool bold) {
+    std::pair<unsigned int, bool> key(characterSize, bold);
+    if (std::find(textSizes.begin(), textSizes.end(), key) == textSizes.end()) {
+        textSizes.push_back(key);
+    }
+}
+
+void DrawList::submit(sf::RenderTarget& target) const {
+    target.setView(view);
+    target.clear(clearColor);
+    drawRange(target, 0, commands.size());
+}
+
+void DrawList::submitScene(sf::RenderTarget& target) const {
+    target.setView(view);
+    target.clear(clearColor);
+    drawRange(target, 0, sceneEnd);
+}
+
+void DrawList::submitOverlay(sf::RenderTarget& target) const {
+    target.setView(view);
+    drawRange(target, sceneEnd, commands.size());
+}
+
+void DrawList::drawRange(sf::RenderTarget& target, size_t first, size_t last) const {
+    for (size_t i = first; i < last; ++i) {
+        const Command& command = commands[i];
+        if (command.viewIndex >= 0) {
+            target.setView(views[command.viewIndex]);
+            continue;
+        }
+        const sf::Drawable& drawable = command.owned ? *command.owned : *command.borrowed;
+        target.draw(drawable, command.states);
+    }
+}
@@ -0,0 +1,124 @@
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+
+// An immutable-once-published record of one frame. draw() copies the
+// drawable so the caller can keep changing its own object; the copies live
+// in per-type pools that reset() keeps, so a list reused every frame stops
+// allocating once the pools have grown to the busiest frame. drawShared()
+// keeps a reference to an object that is never modified again, and
+// drawStatic() is for objects that live for the whole session unchanged.
+//
+// Everything recorded before endScene() is the scene, which may be drawn
+// at a reduced resolution; the rest is the overlay (text and widgets),
+// which is always drawn at native resolution. Both start in the list's
+// view; changeView() switches the view for the commands after it, as the
+// world camera does.
+class DrawList {
+public:
+    template <typename T>
+    void draw(const T& drawable, const sf::RenderStates& states = sf::RenderStates::Default) {
+        T& copy = allocate<T>();
+        copy = drawable;
+        commands.push_back({nullptr, &copy, states});
+        if constexpr (std::is_same<T, sf::Text>::value) {
+            textCount++;
+            noteTextSize(drawable.getCharacterSize(), (drawable.getStyle() & sf::Text::Bold) != 0);
+        }
+    }
+    
+    void drawShared(std::shared_ptr<const sf::Drawable> drawable,
+                    const sf::RenderStates& states = sf::RenderStates::Default) {
+        commands.push_back({std::move(drawable), nullptr, states});
+    }
+    
+    void drawStatic(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default) {
+        commands.push_back({nullptr, &drawable, states});
+    }
+    
+    void changeView(const sf::View& view) {
+        views.push_back(view);
+        commands.push_back({nullptr, nullptr, sf::RenderStates::Default, static_cast<int>(views.size()) - 1});
+    }
+    
+    void setClearColor(const sf::Color& color) { clearColor = color; }
+    void setView(const sf::View& view) { this->view = view; }
+    const sf::View& getView() const { return view; }
+    
+    void endScene() { sceneEnd = commands.size(); }
+    
+    void reset();
+    void noteTextSize(unsigned int characterSize, bool bold);
+    void submit(sf::RenderTarget& target) const;
+    void submitScene(sf::RenderTarget& target) const;
+    void submitOverlay(sf::RenderTarget& target) const;
+    
+    size_t size() const { return commands.size(); }
+    size_t getTextCount() const { return textCount; }
+    
+    // Distinct (character size, bold) pairs of the text copied into the list.
+    const std::vector<std::pair<unsigned int, bool>>& getTextSizes() const { return textSizes; }
+
+private:
+    struct Command {
+        std::shared_ptr<const sf::Drawable> owned;
+        const sf::Drawable* borrowed;
+        sf::RenderStates states;
+        int viewIndex = -1;
+    };
+    
+    struct PoolBase {
+        virtual ~PoolBase() = default;
+        size_t used = 0;
+    };
+    
+    template <typename T>
+    struct Pool : PoolBase {
+        std::vector<std::unique_ptr<T>> items;
+    };
+    
+    template <typename T>
+    T& allocate() {
+        size_t index = poolIndex<T>();
+        if (index >= pools.size()) {
+            pools.resize(index + 1);
+        }
+        if (!pools[index]) {
+            pools[index] = std::make_unique<Pool<T>>();
+        }
+        
+        Pool<T>& pool = static_cast<Pool<T>&>(*pools[index]);
+        if (pool.used == pool.items.size()) {
+            pool.items.push_back(std::make_unique<T>());
+        }
+        return *pool.items[pool.used++];
+    }
+    
+    template <typename T>
+    static size_t poolIndex() {
+        static const size_t index = nextPoolIndex++;
+        return index;
+    }
+    
+    static std::atomic<size_t> nextPoolIndex;
+    
+    std::vector<std::unique_ptr<PoolBase>> pools;
+    std::vector<Command> commands;
+    std::vector<sf::View> views;
+    size_t sceneEnd = 0;
+    size_t textCount = 0;
+    std::vector<std::pair<unsigned int, bool>> textSizes;
+    sf::Color clearColor;
+    sf::View view;
+    
+    void drawRange(sf::RenderTarget& target, size_t first, size_t last) const;
+};
+
+#endif
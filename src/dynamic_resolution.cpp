@@ -0,0 +1,161 @@
+#include "dynamic_resolution.h"
+#include <SFML/OpenGL.hpp>
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+namespace {
+
+// Frames to let the average settle after a level change before judging it.
+const int SETTLE_FRAMES = 20;
+// Frames of sustained headroom needed before trying a higher level.
+const int RAISE_FRAMES = 120;
+const float AVERAGE_WEIGHT = 0.1f;
+const float LOWER_THRESHOLD = 0.85f;
+const float RAISE_THRESHOLD = 0.7f;
+
+}
+
+// Ordered from best to cheapest: MSAA goes first, then resolution.
+const DynamicResolution::Level DynamicResolution::LEVELS[] = {
+    {1.0f, 8},
+    {1.0f, 4},
+    {1.0f, 2},
+    {1.0f, 0},
+    {0.85f, 0},
+    {0.7f, 0},
+    {0.6f, 0},
+    {0.5f, 0}
+};
+
+const int DynamicResolution::LEVEL_COUNT = sizeof(LEVELS) / sizeof(LEVELS[0]);
+
+DynamicResolution::DynamicResolution(sf::Time target)
+    : enabled(false)
+    , target(target)
+    , level(0)
+    , textureLevel(-1)
+    , averageCost(0.0f)
+    , framesAtLevel(0)
+    , framesWithHeadroom(0) {
+}
+
+void DynamicResolution::submit(const DrawList& frame, sf::RenderTarget& target) {
+    if (!enabled || !prepareTexture(target.getSize())) {
+        frame.submit(target);
+        return;
+    }
+    
+    frame.submitScene(sceneTexture);
+    sceneTexture.display();
+    
+    sf::Sprite scene(sceneTexture.getTexture());
+    float scale = LEVELS[textureLevel].scale;
+    scene.setScale(1.0f / scale, 1.0f / scale);
+    
+    target.setView(target.getDefaultView());
+    target.draw(scene);
+    frame.submitOverlay(target);
+}
+
+void DynamicResolution::finish() {
+    if (enabled) {
+        glFinish();
+    }
+}
+
+void DynamicResolution::update(sf::Time frameCost) {
+    if (!enabled) {
+        return;
+    }
+    
+    float cost = frameCost.asSeconds();
+    averageCost = framesAtLevel == 0 ? cost : averageCost + (cost - averageCost) * AVERAGE_WEIGHT;
+    if (++framesAtLevel < SETTLE_FRAMES) {
+        return;
+    }
+    
+    float budget = target.asSeconds();
+    int current = level;
+    if (averageCost > budget * LOWER_THRESHOLD && current + 1 < LEVEL_COUNT) {
+        setLevel(current + 1);
+        return;
+    }
+    
+    if (current == 0) {
+        return;
+    }
+    
+    // Only step up if the better level is still expected to fit: cost
+    // scales roughly with the number of pixels drawn.
+    const Level& now = LEVELS[current];
+    const Level& better = LEVELS[current - 1];
+    float pixelRatio = (better.scale * better.scale) / (now.scale * now.scale);
+    float samplesRatio = static_cast<float>(std::max(1u, better.antialiasing)) / std::max(1u, now.antialiasing);
+    float predicted = averageCost * pixelRatio * samplesRatio;
+    
+    if (predicted < budget * RAISE_THRESHOLD) {
+        if (++framesWithHeadroom >= RAISE_FRAMES) {
+            setLevel(current - 1);
+        }
+    } else {
+        framesWithHeadroom = 0;
+    }
+}
+
+float DynamicResolution::getScale() const {
+    return LEVELS[level].scale;
+}
+
+unsigned int DynamicResolution::getAntialiasingLevel() const {
+    return LEVELS[level].antialiasing;
+}
+
+bool DynamicResolution::isSoftwareRenderer() {
+    sf::Context context;
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+    if (!renderer) {
+        return false;
+    }
+    
+    std::string name(reinterpret_cast<const char*>(renderer));
+    std::cout << "GL renderer: " << name << std::endl;
+    return name.find("llvmpipe") != std::string::npos ||
+           name.find("softpipe") != std::string::npos ||
+           name.find("Software Rasterizer") != std::string::npos;
+}
+
+bool DynamicResolution::prepareTexture(const sf::Vector2u& windowSize) {
+    int wanted = level;
+    if (wanted == textureLevel) {
+        return true;
+    }
+    
+    const Level& settings = LEVELS[wanted];
+    unsigned int width = std::max(1u, static_cast<unsigned int>(windowSize.x * settings.scale));
+    unsigned int height = std::max(1u, static_cast<unsigned int>(windowSize.y * settings.scale));
+    
+    sf::ContextSettings context;
+    context.antialiasingLevel = std::min(settings.antialiasing, sf::RenderTexture::getMaximumAntialiasingLevel());
+    if (!sceneTexture.create(width, height, context)) {
+        std::cerr << "Cannot create " << width << "x" << height
+                  << " scene texture, drawing at native resolution" << std::endl;
+        enabled = false;
+        textureLevel = -1;
+        return false;
+    }
+    
+    sceneTexture.setSmooth(true);
+    textureLevel = wanted;
+    return true;
+}
+
+void DynamicResolution::setLevel(int newLevel) {
+    const Level& settings = LEVELS[newLevel];
+    std::cout << "Dynamic resolution: " << static_cast<int>(settings.scale * 100.0f + 0.5f) << "% scene, "
+              << settings.antialiasing << "x MSAA (frame cost " << averageCost * 1000.0f << " ms)" << std::endl;
+    
+    level = newLevel;
+    framesAtLevel = 0;
+    framesWithHeadroom = 0;
+}
@@ -0,0 +1,59 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include "draw_list.h"
+
+// Renders the scene part of a DrawList into an offscreen texture at an
+// internal resolution and MSAA level chosen from the measured frame cost,
+// then scales it up to the window and draws the overlay on top at native
+// resolution. Meant for software GL (Mesa llvmpipe), where full-size 8x
+// MSAA does not fit the frame budget. Used only from the render thread,
+// apart from the getters.
+class DynamicResolution {
+public:
+    explicit DynamicResolution(sf::Time target = sf::seconds(1.0f / 60.0f));
+    
+    void setEnabled(bool enabled) { this->enabled = enabled; }
+    bool isEnabled() const { return enabled; }
+    
+    void submit(const DrawList& frame, sf::RenderTarget& target);
+    
+    // Waits for the GL to finish the frame so that the measured cost
+    // includes rasterisation, which llvmpipe defers until a flush.
+    void finish();
+    
+    // Feeds the cost of the last frame and moves between quality levels.
+    void update(sf::Time frameCost);
+    
+    float getScale() const;
+    unsigned int getAntialiasingLevel() const;
+    
+    static bool isSoftwareRenderer();
+
+private:
+    struct Level {
+        float scale;
+        unsigned int antialiasing;
+    };
+    
+    static const Level LEVELS[];
+    static const int LEVEL_COUNT;
+    
+    bool enabled;
+    sf::Time target;
+    std::atomic<int> level;
+    
+    sf::RenderTexture sceneTexture;
+    int textureLevel;
+    
+    float averageCost;
+    int framesAtLevel;
+    int framesWithHeadroom;
+    
+    bool prepareTexture(const sf::Vector2u& windowSize);
+    void setLevel(int newLevel);
+};
+
+#endif
@@ -0,0 +1,308 @@
+#include "frame_capture.h"
+#include <SFML/OpenGL.hpp>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+const char* CAPTURE_DIRECTORY = "captures";
+
+// Buffer objects are GL 1.5 and not exported on every platform, so they
+// are looked up through SFML once a context exists.
+PFNGLGENBUFFERSPROC genBuffers = nullptr;
+PFNGLDELETEBUFFERSPROC deleteBuffers = nullptr;
+PFNGLBINDBUFFERPROC bindBuffer = nullptr;
+PFNGLBUFFERDATAPROC bufferData = nullptr;
+PFNGLMAPBUFFERPROC mapBuffer = nullptr;
+PFNGLUNMAPBUFFERPROC unmapBuffer = nullptr;
+
+template <typename T>
+bool loadFunction(T& function, const char* name) {
+    function = reinterpret_cast<T>(sf::Context::getFunction(name));
+    return function != nullptr;
+}
+
+}
+
+FrameCapture::FrameCapture()
+    : screenshotRequested(false)
+    , recordingWanted(false)
+    , recording(false)
+    , sessionFrames(0)
+    , sessionDropStart(0)
+    , pixelBuffersChecked(false)
+    , usePixelBuffers(false)
+    , pixelBuffers{0, 0}
+    , bufferBytes(0)
+    , nextReadback(0)
+    , stopping(false)
+    , writtenFrames(0)
+    , droppedFrames(0) {
+    
+    for (size_t i = 0; i < POOL_SIZE; ++i) {
+        freeFrames.push_back(std::make_unique<Frame>());
+    }
+}
+
+FrameCapture::~FrameCapture() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    if (encoder.joinable()) {
+        encoder.join();
+    }
+}
+
+void FrameCapture::capture(const sf::Vector2u& size) {
+    if (recordingWanted != recording) {
+        if (recordingWanted) {
+            beginSession();
+        } else {
+            endSession();
+        }
+    }
+    
+    std::string path;
+    if (screenshotRequested.exchange(false)) {
+        std::error_code error;
+        std::filesystem::create_directories(CAPTURE_DIRECTORY, error);
+        path = std::string(CAPTURE_DIRECTORY) + "/screenshot_" + timestamp() + ".png";
+        std::cout << "Capturing screenshot to " << path << std::endl;
+    } else if (recording && (sessionFrames == 0 || recordClock.getElapsedTime().asSeconds() >= RECORD_INTERVAL)) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/frame_%06lu.png", sessionFrames++);
+        path = sessionDirectory + name;
+        recordClock.restart();
+    }
+    
+    if (path.empty()) {
+        flush();
+        return;
+    }
+    
+    if (preparePixelBuffers(size)) {
+        startReadback(size, path);
+    } else {
+        readNow(size, path);
+    }
+}
+
+void FrameCapture::flush() {
+    // Oldest first, so recorded frames stay in order.
+    for (int i = 0; i < 2; ++i) {
+        int slot = (nextReadback + i) % 2;
+        if (readbacks[slot].pending) {
+            finishReadback(slot);
+        }
+    }
+}
+
+void FrameCapture::release() {
+    flush();
+    if (usePixelBuffers) {
+        deleteBuffers(2, pixelBuffers);
+        pixelBuffers[0] = pixelBuffers[1] = 0;
+    }
+    usePixelBuffers = false;
+    pixelBuffersChecked = false;
+    bufferBytes = 0;
+    
+    if (recording) {
+        endSession();
+    }
+}
+
+bool FrameCapture::loadPixelBuffers() {
+    bool loaded = loadFunction(genBuffers, "glGenBuffers") &&
+                  loadFunction(deleteBuffers, "glDeleteBuffers") &&
+                  loadFunction(bindBuffer, "glBindBuffer") &&
+                  loadFunction(bufferData, "glBufferData") &&
+                  loadFunction(mapBuffer, "glMapBuffer") &&
+                  loadFunction(unmapBuffer, "glUnmapBuffer");
+    if (!loaded) {
+        std::cerr << "Pixel buffer objects unavailable, captures read back synchronously" << std::endl;
+        return false;
+    }
+    
+    genBuffers(2, pixelBuffers);
+    return true;
+}
+
+bool FrameCapture::preparePixelBuffers(const sf::Vector2u& size) {
+    if (!pixelBuffersChecked) {
+        pixelBuffersChecked = true;
+        usePixelBuffers = loadPixelBuffers();
+    }
+    if (!usePixelBuffers) {
+        return false;
+    }
+    
+    size_t bytes = static_cast<size_t>(size.x) * size.y * 4;
+    if (bytes != bufferBytes) {
+        flush();
+        for (unsigned int buffer : pixelBuffers) {
+            bindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+            bufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        }
+        bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        bufferBytes = bytes;
+    }
+    return true;
+}
+
+void FrameCapture::startReadback(const sf::Vector2u& size, const std::string& path) {
+    int slot = nextReadback;
+    if (readbacks[slot].pending) {
+        finishReadback(slot);
+    }
+    
+    // With a pack buffer bound glReadPixels only queues the copy.
+    bindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[slot]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    
+    readbacks[slot].pending = true;
+    readbacks[slot].size = size;
+    readbacks[slot].path = path;
+    nextReadback = 1 - slot;
+    
+    // The other buffer was filled a frame ago and should be ready by now.
+    if (readbacks[nextReadback].pending) {
+        finishReadback(nextReadback);
+    }
+}
+
+void FrameCapture::finishReadback(int slot) {
+    Readback& readback = readbacks[slot];
+    readback.pending = false;
+    
+    std::unique_ptr<Frame> frame = takeFrame(readback.size);
+    if (!frame) {
+        droppedFrames++;
+        return;
+    }
+    
+    bindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[slot]);
+    const void* pixels = mapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (pixels) {
+        std::memcpy(frame->pixels.data(), pixels, frame->pixels.size());
+        unmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    
+    if (!pixels) {
+        std::cerr << "Cannot map capture buffer, dropping " << readback.path << std::endl;
+        droppedFrames++;
+        std::lock_guard<std::mutex> lock(queueMutex);
+        freeFrames.push_back(std::move(frame));
+        return;
+    }
+    
+    frame->path = readback.path;
+    enqueue(std::move(frame));
+}
+
+void FrameCapture::readNow(const sf::Vector2u& size, const std::string& path) {
+    std::unique_ptr<Frame> frame = takeFrame(size);
+    if (!frame) {
+        droppedFrames++;
+        return;
+    }
+    
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, frame->pixels.data());
+    frame->path = path;
+    enqueue(std::move(frame));
+}
+
+std::unique_ptr<FrameCapture::Frame> FrameCapture::takeFrame(const sf::Vector2u& size) {
+    std::unique_ptr<Frame> frame;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (freeFrames.empty()) {
+            return nullptr;
+        }
+        frame = std::move(freeFrames.back());
+        freeFrames.pop_back();
+    }
+    
+    frame->size = size;
+    frame->pixels.resize(static_cast<size_t>(size.x) * size.y * 4);
+    return frame;
+}
+
+void FrameCapture::enqueue(std::unique_ptr<Frame> frame) {
+    if (!encoder.joinable()) {
+        encoder = std::thread(&FrameCapture::encodeLoop, this);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(std::move(frame));
+    }
+    queueReady.notify_one();
+}
+
+void FrameCapture::encodeLoop() {
+    while (true) {
+        std::unique_ptr<Frame> frame;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            frame = std::move(queue.front());
+            queue.pop_front();
+        }
+        
+        // GL rows start at the bottom.
+        sf::Image image;
+        image.create(frame->size.x, frame->size.y, frame->pixels.data());
+        image.flipVertically();
+        if (image.saveToFile(frame->path)) {
+            writtenFrames++;
+        } else {
+            std::cerr << "Cannot write capture: " << frame->path << std::endl;
+        }
+        
+        std::lock_guard<std::mutex> lock(queueMutex);
+        freeFrames.push_back(std::move(frame));
+    }
+}
+
+void FrameCapture::beginSession() {
+    sessionDirectory = std::string(CAPTURE_DIRECTORY) + "/session_" + timestamp();
+    std::error_code error;
+    std::filesystem::create_directories(sessionDirectory, error);
+    if (error) {
+        std::cerr << "Cannot create " << sessionDirectory << ": " << error.message() << std::endl;
+        recordingWanted = false;
+        return;
+    }
+    
+    recording = true;
+    sessionFrames = 0;
+    sessionDropStart = droppedFrames;
+    std::cout << "Recording to " << sessionDirectory << std::endl;
+}
+
+void FrameCapture::endSession() {
+    flush();
+    recording = false;
+    std::cout << "Recording stopped: " << sessionFrames << " frames, "
+              << droppedFrames - sessionDropStart << " of them dropped" << std::endl;
+}
+
+std::string FrameCapture::timestamp() {
+    std::time_t now = std::time(nullptr);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y%m%d_%H%M%S", std::localtime(&now));
+    return buffer;
+}
@@ -0,0 +1,105 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Screenshots and session recording without stalling a frame. The render
+// thread reads the back buffer into one of two pixel buffer objects and
+// maps the other one, filled a frame earlier, so the GPU copy overlaps the
+// next frame instead of blocking on it. Mapped frames are copied into a
+// fixed pool and handed to an encoder thread that writes PNG files. When
+// the pool is exhausted the frame is dropped, so a slow disk costs frames
+// in the recording, not in the game.
+//
+// The requests come from the main thread; everything else runs on the
+// render thread with the window's context active.
+class FrameCapture {
+public:
+    FrameCapture();
+    ~FrameCapture();
+    
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+    
+    // Main thread.
+    void requestScreenshot() { screenshotRequested = true; }
+    void setRecording(bool recording) { recordingWanted = recording; }
+    bool isRecording() const { return recordingWanted; }
+    
+    // Render thread: after the frame is drawn, before display().
+    void capture(const sf::Vector2u& size);
+    // Render thread: collects a readback still in flight when no new
+    // frame is coming.
+    void flush();
+    // Render thread: frees the GL objects; the context must be active.
+    void release();
+    
+    unsigned long getWrittenFrames() const { return writtenFrames; }
+    unsigned long getDroppedFrames() const { return droppedFrames; }
+    
+    static const size_t POOL_SIZE = 8;
+    static constexpr float RECORD_INTERVAL = 1.0f / 30.0f;
+
+private:
+    struct Frame {
+        std::vector<sf::Uint8> pixels;
+        sf::Vector2u size;
+        std::string path;
+    };
+    
+    struct Readback {
+        bool pending = false;
+        sf::Vector2u size;
+        std::string path;
+    };
+    
+    std::atomic<bool> screenshotRequested;
+    std::atomic<bool> recordingWanted;
+    
+    bool recording;
+    std::string sessionDirectory;
+    unsigned long sessionFrames;
+    unsigned long sessionDropStart;
+    sf::Clock recordClock;
+    
+    bool pixelBuffersChecked;
+    bool usePixelBuffers;
+    unsigned int pixelBuffers[2];
+    size_t bufferBytes;
+    Readback readbacks[2];
+    int nextReadback;
+    
+    std::vector<std::unique_ptr<Frame>> freeFrames;
+    std::deque<std::unique_ptr<Frame>> queue;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    bool stopping;
+    std::thread encoder;
+    
+    std::atomic<unsigned long> writtenFrames;
+    std::atomic<unsigned long> droppedFrames;
+    
+    bool loadPixelBuffers();
+    bool preparePixelBuffers(const sf::Vector2u& size);
+    void startReadback(const sf::Vector2u& size, const std::string& path);
+    void finishReadback(int slot);
+    void readNow(const sf::Vector2u& size, const std::string& path);
+    
+    std::unique_ptr<Frame> takeFrame(const sf::Vector2u& size);
+    void enqueue(std::unique_ptr<Frame> frame);
+    void encodeLoop();
+    
+    void beginSession();
+    void endSession();
+    static std::string timestamp();
+};
+
+#endif
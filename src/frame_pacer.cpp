@@ -0,0 +1,177 @@
+#include "frame_pacer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+const float COST_WEIGHT = 0.1f;
+// Headroom added to the predicted cost, in mean absolute deviations.
+const float COST_DEVIATIONS = 3.0f;
+const int64_t COST_MARGIN_NANOS = 500000;
+const int64_t MIN_SPIN_NANOS = 500000;
+const int64_t MAX_SPIN_NANOS = 4000000;
+// Intervals longer than this many periods are idle time between
+// on-demand frames, not pacing.
+const int IDLE_PERIODS = 4;
+const int64_t UNCAPPED_IDLE_NANOS = 100000000;
+
+}
+
+FramePacer::FramePacer(Mode mode, int framesPerSecond)
+    : slotNanos(0)
+    , workNanos(0)
+    , predictedNanos(0)
+    , spinNanos(2000000)
+    , averageCost(0.0f)
+    , costDeviation(0.0f)
+    , lastPresentNanos(0)
+    , presentedFrames(0)
+    , missedSlots(0)
+    , intervalCount(0)
+    , intervalMean(0.0)
+    , intervalSquares(0.0)
+    , worstError(0.0) {
+    
+    setMode(mode, framesPerSecond);
+}
+
+void FramePacer::setMode(Mode mode, int framesPerSecond) {
+    this->mode = mode;
+    this->framesPerSecond = std::max(1, framesPerSecond);
+    periodNanos = mode == Mode::UNCAPPED ? 0 : 1000000000LL / this->framesPerSecond;
+}
+
+void FramePacer::apply(sf::Window& window) const {
+    // The pacer replaces SFML's limiter, which would sleep again in display().
+    window.setFramerateLimit(0);
+    window.setVerticalSyncEnabled(mode == Mode::VSYNC);
+    
+    std::cout << "Frame pacing: " << getModeName(mode);
+    if (mode != Mode::UNCAPPED) {
+        std::cout << " at " << framesPerSecond << " fps";
+    }
+    std::cout << std::endl;
+}
+
+void FramePacer::waitForFrameStart() {
+    int64_t slot = slotNanos;
+    if (mode == Mode::UNCAPPED || slot == 0) {
+        return;
+    }
+    
+    int64_t start = slot + periodNanos - predictedNanos;
+    if (start > now()) {
+        sleepUntil(start);
+    }
+}
+
+void FramePacer::beginWork() {
+    workStart = Clock::now();
+}
+
+void FramePacer::endWork() {
+    workNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - workStart).count();
+}
+
+void FramePacer::waitForPresent(sf::Time submitTime) {
+    float cost = static_cast<float>(workNanos + submitTime.asMicroseconds() * 1000);
+    if (presentedFrames == 0) {
+        // Start pessimistic; the estimate tightens as frames come in.
+        averageCost = cost;
+        costDeviation = cost;
+    } else {
+        averageCost += (cost - averageCost) * COST_WEIGHT;
+        costDeviation += (std::abs(cost - averageCost) - costDeviation) * COST_WEIGHT;
+    }
+    predictedNanos = static_cast<int64_t>(averageCost + COST_DEVIATIONS * costDeviation) + COST_MARGIN_NANOS;
+    
+    int64_t current = now();
+    if (mode == Mode::UNCAPPED) {
+        slotNanos = current;
+        return;
+    }
+    
+    int64_t slot = slotNanos + periodNanos;
+    if (slotNanos == 0 || slot < current) {
+        // Late, or the first frame after idling: present right away and
+        // schedule the following frames from here.
+        if (slotNanos != 0 && current - slot < IDLE_PERIODS * periodNanos) {
+            missedSlots++;
+        }
+        slot = current;
+    }
+    slotNanos = slot;
+    
+    if (mode == Mode::CAP) {
+        sleepUntil(slot);
+    }
+}
+
+void FramePacer::presented() {
+    int64_t current = now();
+    if (mode == Mode::VSYNC) {
+        // The driver decides the actual slot.
+        slotNanos = current;
+    }
+    
+    int64_t idleNanos = mode == Mode::UNCAPPED ? UNCAPPED_IDLE_NANOS : IDLE_PERIODS * periodNanos;
+    if (lastPresentNanos != 0 && current - lastPresentNanos < idleNanos) {
+        double interval = (current - lastPresentNanos) / 1.0e6;
+        intervalCount++;
+        double delta = interval - intervalMean;
+        intervalMean += delta / intervalCount;
+        intervalSquares += delta * (interval - intervalMean);
+        if (periodNanos > 0) {
+            worstError = std::max(worstError, std::abs(interval - periodNanos / 1.0e6));
+        }
+    }
+    
+    lastPresentNanos = current;
+    presentedFrames++;
+}
+
+float FramePacer::getJitterMs() const {
+    return intervalCount > 1 ? static_cast<float>(std::sqrt(intervalSquares / (intervalCount - 1))) : 0.0f;
+}
+
+void FramePacer::printReport() const {
+    std::cout << "Frame pacing (" << getModeName(mode) << "): " << presentedFrames << " frames, mean interval "
+              << intervalMean << " ms, jitter " << getJitterMs() << " ms";
+    if (periodNanos > 0) {
+        std::cout << ", worst " << worstError << " ms off the " << periodNanos / 1.0e6 << " ms period, "
+                  << missedSlots << " missed slots";
+    }
+    std::cout << std::endl;
+}
+
+const char* FramePacer::getModeName(Mode mode) {
+    switch (mode) {
+        case Mode::VSYNC: return "vsync";
+        case Mode::CAP: return "cap";
+        case Mode::UNCAPPED: return "uncapped";
+        default: return "unknown";
+    }
+}
+
+void FramePacer::sleepUntil(int64_t targetNanos) {
+    int64_t spin = spinNanos;
+    int64_t remaining = targetNanos - now();
+    if (remaining > spin) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - spin));
+        
+        // Keep the spin window about twice the typical oversleep.
+        int64_t overslept = now() - (targetNanos - spin);
+        int64_t wanted = std::max(MIN_SPIN_NANOS, std::min(2 * overslept, MAX_SPIN_NANOS));
+        spinNanos = spin + (wanted - spin) / 8;
+    }
+    
+    while (now() < targetNanos) {
+        std::this_thread::yield();
+    }
+}
+
+int64_t FramePacer::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
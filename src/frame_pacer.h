@@ -0,0 +1,86 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Spaces presented frames evenly. setFramerateLimit() sleeps inside
+// display() with sf::sleep, which oversleeps by up to several
+// milliseconds; instead the render thread presents each frame at its slot
+// on a steady clock, sleeping most of the way and spinning the rest, and
+// the main thread starts the next frame only as long before its slot as
+// the frame is predicted to take, so it is neither late nor stale.
+//
+// CAP paces to a fixed rate, VSYNC leaves the wait to the driver and only
+// schedules frame starts, UNCAPPED does neither (for benchmarking).
+class FramePacer {
+public:
+    enum class Mode {
+        VSYNC,
+        CAP,
+        UNCAPPED
+    };
+    
+    using Clock = std::chrono::steady_clock;
+    
+    explicit FramePacer(Mode mode = Mode::CAP, int framesPerSecond = 60);
+    
+    // Before the render thread starts; apply() then configures the window.
+    void setMode(Mode mode, int framesPerSecond);
+    Mode getMode() const { return mode; }
+    void apply(sf::Window& window) const;
+    
+    // Main thread: waits until the next frame should start, then measures
+    // the work up to endWork(), just before the frame is published.
+    void waitForFrameStart();
+    void beginWork();
+    void endWork();
+    
+    // Render thread: waits for the frame's slot after submitting it, and
+    // is told when display() returned.
+    void waitForPresent(sf::Time submitTime);
+    void presented();
+    
+    // Standard deviation of the intervals between presented frames,
+    // leaving out idle gaps between on-demand frames. Read once the render
+    // thread has stopped.
+    float getJitterMs() const;
+    float getPredictedCostMs() const { return predictedNanos / 1.0e6f; }
+    void printReport() const;
+    
+    static const char* getModeName(Mode mode);
+
+private:
+    Mode mode;
+    int framesPerSecond;
+    int64_t periodNanos;
+    
+    // Present slot of the frame the render thread holds, shared with the
+    // main thread. Zero before the first frame.
+    std::atomic<int64_t> slotNanos;
+    std::atomic<int64_t> workNanos;
+    std::atomic<int64_t> predictedNanos;
+    // How early to stop sleeping and start spinning; adapts to how much
+    // the OS oversleeps.
+    std::atomic<int64_t> spinNanos;
+    
+    Clock::time_point workStart;
+    
+    float averageCost;
+    float costDeviation;
+    
+    int64_t lastPresentNanos;
+    unsigned long presentedFrames;
+    unsigned long missedSlots;
+    unsigned long intervalCount;
+    double intervalMean;
+    double intervalSquares;
+    double worstError;
+    
+    void sleepUntil(int64_t targetNanos);
+    static int64_t now();
+};
+
+#endif
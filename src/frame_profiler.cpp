@@ -0,0 +1,132 @@
+#include "frame_profiler.h"
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+namespace {
+
+const float GRAPH_HEIGHT = 90.0f;
+const float GRAPH_MAX_MS = 50.0f;
+const float BAR_WIDTH = 2.0f;
+const float TARGET_MS = 1000.0f / 60.0f;
+
+const char* PHASE_NAMES[] = {"events", "update", "record", "submit", "display"};
+
+}
+
+FrameProfiler::FrameProfiler(size_t historySize)
+    : frameTimes(std::max<size_t>(1, historySize), 0.0f)
+    , phaseTimes(std::max<size_t>(1, historySize))
+    , next(0)
+    , count(0)
+    , lastDrawCalls(0)
+    , lastTextObjects(0)
+    , visible(false) {
+    
+    current.fill(0.0f);
+}
+
+void FrameProfiler::addTime(Phase phase, sf::Time time) {
+    current[phase] += time.asMicroseconds() / 1000.0f;
+}
+
+void FrameProfiler::endFrame(const std::string& recordLabel, size_t drawCalls, size_t textObjects) {
+    frameTimes[next] = frameClock.restart().asMicroseconds() / 1000.0f;
+    phaseTimes[next] = current;
+    current.fill(0.0f);
+    
+    next = (next + 1) % frameTimes.size();
+    count = std::min(count + 1, frameTimes.size());
+    
+    lastRecordLabel = recordLabel;
+    lastDrawCalls = drawCalls;
+    lastTextObjects = textObjects;
+}
+
+float FrameProfiler::getPercentile(float p) const {
+    if (count == 0) {
+        return 0.0f;
+    }
+    
+    std::vector<float> sorted(frameTimes.begin(), frameTimes.begin() + count);
+    size_t index = std::min(count - 1, static_cast<size_t>(p * (count - 1) + 0.5f));
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+void FrameProfiler::refreshStats() {
+    std::array<float, PHASE_COUNT> average;
+    average.fill(0.0f);
+    for (size_t i = 0; i < count; ++i) {
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            average[phase] += phaseTimes[i][phase];
+        }
+    }
+    
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "frame  p50 " << getPercentile(0.50f) << "  p95 " << getPercentile(0.95f)
+       << "  p99 " << getPercentile(0.99f) << " ms  (" << count << " frames)\n";
+    
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        ss << PHASE_NAMES[phase];
+        if (phase == RECORD && !lastRecordLabel.empty()) {
+            ss << " [" << lastRecordLabel << "]";
+        }
+        ss << " " << (count > 0 ? average[phase] / count : 0.0f) << (phase + 1 < PHASE_COUNT ? "   " : " ms avg\n");
+    }
+    
+    ss << "draw calls " << lastDrawCalls << "   text objects " << lastTextObjects;
+    statsString = ss.str();
+}
+
+void FrameProfiler::draw(DrawList& frame, const sf::Font& font, const sf::Vector2f& position) {
+    if (!visible) {
+        return;
+    }
+    
+    if (statsString.empty() || textRefresh.getElapsedTime().asSeconds() >= 0.25f) {
+        refreshStats();
+        textRefresh.restart();
+    }
+    
+    float graphWidth = frameTimes.size() * BAR_WIDTH;
+    
+    sf::RectangleShape background(sf::Vector2f(graphWidth + 20.0f, GRAPH_HEIGHT + 90.0f));
+    background.setPosition(position);
+    background.setFillColor(sf::Color(0, 0, 0, 190));
+    frame.draw(background);
+    
+    sf::Vector2f graphOrigin(position.x + 10.0f, position.y + 10.0f + GRAPH_HEIGHT);
+    sf::VertexArray bars(sf::Quads, count * 4);
+    for (size_t i = 0; i < count; ++i) {
+        // Oldest frame on the left.
+        size_t index = (next + frameTimes.size() - count + i) % frameTimes.size();
+        float ms = frameTimes[index];
+        float height = std::min(ms, GRAPH_MAX_MS) / GRAPH_MAX_MS * GRAPH_HEIGHT;
+        sf::Color color = ms <= TARGET_MS ? sf::Color(80, 200, 120)
+                        : ms <= 2.0f * TARGET_MS ? sf::Color(230, 200, 60)
+                        : sf::Color(230, 70, 60);
+        
+        float x = graphOrigin.x + i * BAR_WIDTH;
+        bars[i * 4 + 0] = sf::Vertex(sf::Vector2f(x, graphOrigin.y), color);
+        bars[i * 4 + 1] = sf::Vertex(sf::Vector2f(x + BAR_WIDTH, graphOrigin.y), color);
+        bars[i * 4 + 2] = sf::Vertex(sf::Vector2f(x + BAR_WIDTH, graphOrigin.y - height), color);
+        bars[i * 4 + 3] = sf::Vertex(sf::Vector2f(x, graphOrigin.y - height), color);
+    }
+    frame.draw(bars);
+    
+    sf::VertexArray targetLine(sf::Lines, 2);
+    float targetY = graphOrigin.y - TARGET_MS / GRAPH_MAX_MS * GRAPH_HEIGHT;
+    targetLine[0] = sf::Vertex(sf::Vector2f(graphOrigin.x, targetY), sf::Color(255, 255, 255, 120));
+    targetLine[1] = sf::Vertex(sf::Vector2f(graphOrigin.x + graphWidth, targetY), sf::Color(255, 255, 255, 120));
+    frame.draw(targetLine);
+    
+    sf::Text stats;
+    stats.setFont(font);
+    stats.setString(statsString);
+    stats.setCharacterSize(13);
+    stats.setFillColor(sf::Color::White);
+    stats.setPosition(position.x + 10.0f, graphOrigin.y + 8.0f);
+    frame.draw(stats);
+}
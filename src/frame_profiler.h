@@ -0,0 +1,74 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <string>
+#include <vector>
+#include "draw_list.h"
+
+// Rolling frame-time statistics and a per-phase breakdown for the last
+// historySize frames, shown as a toggleable overlay. Main-thread phases are
+// measured with Scope; the render thread's submit and display times are
+// passed in when the frame is closed.
+class FrameProfiler {
+public:
+    enum Phase {
+        EVENTS,
+        UPDATE,
+        RECORD,
+        SUBMIT,
+        DISPLAY,
+        PHASE_COUNT
+    };
+    
+    class Scope {
+    public:
+        Scope(FrameProfiler& profiler, Phase phase) : profiler(profiler), phase(phase) {}
+        ~Scope() { profiler.addTime(phase, clock.getElapsedTime()); }
+    
+    private:
+        FrameProfiler& profiler;
+        Phase phase;
+        sf::Clock clock;
+    };
+    
+    explicit FrameProfiler(size_t historySize = 240);
+    
+    void addTime(Phase phase, sf::Time time);
+    
+    // Idle waits between on-demand frames are not frame time.
+    void restartFrameClock() { frameClock.restart(); }
+    
+    void endFrame(const std::string& recordLabel, size_t drawCalls, size_t textObjects);
+    
+    // Percentile of the recorded frame times in milliseconds, p in [0, 1].
+    float getPercentile(float p) const;
+    size_t getFrameCount() const { return count; }
+    
+    void toggle() { visible = !visible; }
+    bool isVisible() const { return visible; }
+    
+    void draw(DrawList& frame, const sf::Font& font, const sf::Vector2f& position);
+
+private:
+    std::vector<float> frameTimes;
+    std::vector<std::array<float, PHASE_COUNT>> phaseTimes;
+    size_t next;
+    size_t count;
+    
+    std::array<float, PHASE_COUNT> current;
+    sf::Clock frameClock;
+    
+    std::string lastRecordLabel;
+    size_t lastDrawCalls;
+    size_t lastTextObjects;
+    
+    bool visible;
+    sf::Clock textRefresh;
+    std::string statsString;
+    
+    void refreshStats();
+};
+
+#endif
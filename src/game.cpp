@@ -3,13 +3,31 @@
 #include "game_ui.h"
 #include "game_logic.h"
 #include "game_database.h"
+#include "game_actions.h"
+#include "resource_cache.h"
 #include <iostream>
-#include <cstdlib>
 #include <ctime>
 #include <fstream>
+#include <algorithm>
+#include <cmath>
 
-Game::Game()
-    : window(sf::VideoMode(1024, 768), "AstroLearn", sf::Style::Close | sf::Style::Titlebar)
+namespace {
+
+const float MAX_FRAME_TIME = 0.25f;
+// The first scroll step after idling must not swallow the whole animation.
+const float MAX_SCROLL_STEP = 1.0f / 30.0f;
+const float MIN_TIME_SCALE = 0.25f;
+const float MAX_TIME_SCALE = 64.0f;
+const float ZOOM_STEP = 1.15f;
+// Bodies smaller than this many pixels are still clickable.
+const float PICK_RADIUS_PIXELS = 6.0f;
+const sf::Time IDLE_POLL_SLICE = sf::milliseconds(10);
+const sf::Time FRAME_POLL_TIMEOUT = sf::milliseconds(2);
+
+}
+
+Game::Game(bool createWindow)
+    : renderThread(window)
     , currentState(GameState::LOGIN)
     , isPausedFlag(false)
     , timeScale(1.0f)
@@ -23,9 +41,18 @@ Game::Game()
     , passwordEnterMode(false)
     , confirmPasswordMode(false)
     , foundExistingPlayer(false)
-    , selectedPlanet("") {
-    
-    window.setFramerateLimit(60);
+    , databaseOnline(false)
+    , selectedPlanet("")
+    , currentLayout(UILayout::Id::LOGIN_NAME)
+    , hoveredButton(-1)
+    , hoveredButtonPressed(false)
+    , uiRevision(0)
+    , renderedState(GameState::LOGIN)
+    , frameDirty(true) {
+    
+    if (createWindow) {
+        window.create(sf::VideoMode(1024, 768), "AstroLearn", sf::Style::Close | sf::Style::Titlebar);
+    }
 }
 
 Game::~Game() {
@@ -36,16 +63,18 @@ bool Game::init() {
     std::cout << "Initializing game..." << std::endl;
     
     Database& db = Database::getInstance();
-    std::string connString = "dbname=astrolearn user=postgres password=postgres host=localhost port=5432";
+    std::string connString = "dbname=astrolearn user=postgres password=postgres host=localhost port=5432 connect_timeout=5";
     
-    if (!db.connect(connString)) {
-        std::cerr << "Warning: Could not connect to database. Game will run in offline mode." << std::endl;
-    } else {
-        std::cout << "Database connected successfully" << std::endl;
-    }
+    std::cout << "Connecting to database in background, starting in offline mode" << std::endl;
+    db.connectInBackground(connString);
 
+    bool dynamicResolution = resolutionMode == ResolutionMode::DYNAMIC ||
+        (resolutionMode == ResolutionMode::AUTO && DynamicResolution::isSoftwareRenderer());
+    
+    // With dynamic resolution the scene gets its MSAA from the offscreen
+    // texture; the window itself only carries the native-resolution overlay.
     sf::ContextSettings settings;
-    settings.antialiasingLevel = 8;
+    settings.antialiasingLevel = dynamicResolution ? 0 : 8;
     window.create(sf::VideoMode(1024, 768), "AstroLearn", 
                   sf::Style::Close | sf::Style::Titlebar, settings);
     
@@ -53,8 +82,22 @@ bool Game::init() {
         return false;
     }
     
-    window.setFramerateLimit(60);
+    renderThread.getPacer().apply(window);
     
+    if (dynamicResolution) {
+        renderThread.getDynamicResolution().setEnabled(true);
+        std::cout << "Dynamic resolution enabled" << std::endl;
+    }
+    
+    if (!initContent(static_cast<unsigned>(std::time(nullptr)))) {
+        return false;
+    }
+    
+    std::cout << "Game initialized successfully!" << std::endl;
+    return true;
+}
+
+bool Game::initContent(unsigned int seed) {
     std::vector<std::string> fontPaths = {
         "resources/fonts/Ubuntu-R.ttf",
         "resources/fonts/DejaVuSans.ttf",
@@ -63,50 +106,41 @@ bool Game::init() {
         "/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf"
     };
     
-    bool fontLoaded = false;
-    for (const auto& fontPath : fontPaths) {
-        if (mainFont.loadFromFile(fontPath)) {
-            std::cout << "Font loaded from: " << fontPath << std::endl;
-            fontLoaded = true;
-            break;
-        }
-    }
-    
-    if (!fontLoaded) {
+    if (sf::Font* font = ResourceCache::getInstance().loadFont(fontPaths)) {
+        mainFont = font;
+    } else {
         std::cerr << "Warning: No font file found. Using SFML default." << std::endl;
-        sf::Text tempText;
-        mainFont = *tempText.getFont();
-    }
-    
-    sf::Image backgroundImage;
-    backgroundImage.create(1024, 768, sf::Color(10, 10, 40));
-    
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
-    for (int i = 0; i < 300; ++i) {
-        int x = std::rand() % 1024;
-        int y = std::rand() % 768;
-        int brightness = 150 + std::rand() % 106;
-        backgroundImage.setPixel(x, y, sf::Color(brightness, brightness, brightness));
     }
+    textLayouts.setFont(mainFont);
+    leaderboard.setFont(mainFont);
+    achievementRows.setFont(mainFont);
     
-    backgroundTexture.loadFromImage(backgroundImage);
-    backgroundSprite.setTexture(backgroundTexture);
+    starfield.generate(seed);
     
     solarSystem = std::make_unique<SolarSystem>();
     solarSystem->init();
+    solarSystem->setLabelFont(*mainFont);
     
     quiz = std::make_unique<Quiz>();
+    quiz->seed(seed);
+    
+    if (mainFont != &fallbackFont) {
+        glyphCache.setFont(mainFont);
+        glyphCache.loadManifest();
+        for (const auto& question : quiz->getQuestionBank()) {
+            glyphCache.addText(question.text);
+            glyphCache.addText(question.explanation);
+            for (const auto& option : question.options) {
+                glyphCache.addText(option);
+            }
+        }
+    }
     
     GameLogic::initPlanetInfo(this);
     GameLogic::initPlanetUnlockSystem(this);
     
-    GameUI::initLoginScreen(this);
-    GameUI::initMainMenu(this);
-    GameUI::initQuizUI(this);
-    GameUI::initPlanetInfoUI(this);
-    GameUI::initStatisticsUI(this);
+    setLayout(UILayout::Id::LOGIN_NAME);
     
-    std::cout << "Game initialized successfully!" << std::endl;
     return true;
 }
 
@@ -114,63 +148,187 @@ void Game::run() {
     std::cout << "Starting game loop..." << std::endl;
     
     gameClock.restart();
+    renderThread.start();
     
     while (window.isOpen()) {
+        if (isAnimating()) {
+            renderThread.getPacer().waitForFrameStart();
+        }
+        renderThread.getPacer().beginWork();
+        deltaTime = gameClock.restart();
+        
+        {
+            FrameProfiler::Scope scope(profiler, FrameProfiler::UPDATE);
+            GameDatabase::pollConnection(this);
+            std::lock_guard<std::mutex> lock(renderThread.getResourceMutex());
+            if (ResourceCache::getInstance().pump() > 0) {
+                requestRedraw();
+            }
+            if (glyphPrewarm && !glyphCache.isWarm()) {
+                glyphCache.warmStep(sf::milliseconds(2));
+            }
+        }
         handleEvents();
         
+        if (currentState == GameState::QUIZ) {
+            GameLogic::processQuizCompletion(this);
+        }
+        
         if (currentState == GameState::LOGIN) {
             cursorBlinkTimer += deltaTime.asSeconds();
             if (cursorBlinkTimer >= cursorBlinkTime) {
                 showCursor = !showCursor;
                 cursorBlinkTimer = 0.0f;
+                GameStates::updateLoginCursor(this);
+                requestRedraw();
             }
         }
         
-        if (!isPausedFlag && currentState != GameState::LOGIN) {
-            deltaTime = gameClock.restart();
-            
-            if (currentState == GameState::SOLAR_SYSTEM && solarSystem) {
-                solarSystem->update(deltaTime.asSeconds() * timeScale);
+        if (!isPausedFlag && currentState == GameState::SOLAR_SYSTEM && solarSystem) {
+            FrameProfiler::Scope scope(profiler, FrameProfiler::UPDATE);
+            float frameTime = std::min(deltaTime.asSeconds(), MAX_FRAME_TIME);
+            solarSystem->update(frameTime * timeScale);
+        }
+        
+        if (VirtualList* list = getActiveList()) {
+            if (list->update(std::min(deltaTime.asSeconds(), MAX_SCROLL_STEP))) {
+                requestRedraw();
             }
-        } else {
-            deltaTime = gameClock.restart();
+        }
+        if (currentState == GameState::SOLAR_SYSTEM) {
+            camera.update(std::min(deltaTime.asSeconds(), MAX_SCROLL_STEP));
         }
         
-        render();
+        bool wantsFrame = frameDirty || isAnimating();
+        if (wantsFrame && renderThread.isReadyForFrame()) {
+            frameDirty = false;
+            std::lock_guard<std::mutex> lock(renderThread.getResourceMutex());
+            render();
+        } else if (wantsFrame) {
+            waitForActivity(FRAME_POLL_TIMEOUT);
+        } else {
+            waitForActivity(getIdleTimeout());
+            profiler.restartFrameClock();
+        }
     }
     
+    renderThread.stop();
+    renderThread.getPacer().printReport();
+    glyphCache.saveManifest();
+    glyphCache.printReport();
     std::cout << "Game finished." << std::endl;
 }
 
 void Game::handleEvents() {
     sf::Event event;
     while (window.pollEvent(event)) {
-        switch (event.type) {
-            case sf::Event::Closed:
-                window.close();
-                break;
-                
-            case sf::Event::KeyPressed:
-                handleKeyPress(event.key.code);
-                break;
-                
-            case sf::Event::TextEntered:
-                handleTextInput(event.text.unicode);
-                break;
-                
-            case sf::Event::MouseButtonPressed:
-                if (event.mouseButton.button == sf::Mouse::Left) {
-                    handleMouseClick(event.mouseButton.x, event.mouseButton.y);
-                }
-                break;
-                
-            case sf::Event::MouseMoved:
-                handleMouseMove(event.mouseMove.x, event.mouseMove.y);
-                break;
-                
-            default:
-                break;
+        handleEvent(event);
+    }
+}
+
+void Game::handleEvent(const sf::Event& event) {
+    FrameProfiler::Scope scope(profiler, FrameProfiler::EVENTS);
+    
+    // Hover, drags, scrolling and the solar system view only need a new
+    // frame; the retained trees are rebuilt for input that changes state.
+    requestRedraw();
+    
+    switch (event.type) {
+        case sf::Event::Closed:
+            quit();
+            break;
+            
+        case sf::Event::Resized:
+            invalidateUI();
+            break;
+            
+        case sf::Event::KeyPressed:
+            handleKeyPress(event.key.code);
+            invalidateUI();
+            break;
+            
+        case sf::Event::TextEntered:
+            handleTextInput(event.text.unicode);
+            invalidateUI();
+            break;
+            
+        case sf::Event::MouseButtonPressed:
+            if (event.mouseButton.button == sf::Mouse::Left) {
+                handleMouseClick(event.mouseButton.x, event.mouseButton.y);
+            }
+            break;
+            
+        case sf::Event::MouseButtonReleased:
+            if (event.mouseButton.button == sf::Mouse::Left) {
+                handleMouseRelease(event.mouseButton.x, event.mouseButton.y);
+            }
+            break;
+            
+        case sf::Event::MouseMoved:
+            handleMouseMove(event.mouseMove.x, event.mouseMove.y);
+            break;
+            
+        case sf::Event::MouseWheelScrolled:
+            if (VirtualList* list = getActiveList()) {
+                list->handleWheel(event.mouseWheelScroll.delta, event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+            } else if (currentState == GameState::SOLAR_SYSTEM) {
+                camera.zoomAt(std::pow(ZOOM_STEP, event.mouseWheelScroll.delta),
+                              sf::Vector2i(event.mouseWheelScroll.x, event.mouseWheelScroll.y));
+            }
+            break;
+            
+        default:
+            break;
+    }
+}
+
+bool Game::isAnimating() const {
+    const VirtualList* list = getActiveList();
+    return (currentState == GameState::SOLAR_SYSTEM && (!isPausedFlag || camera.isMoving())) ||
+           (list && list->isScrolling());
+}
+
+VirtualList* Game::getActiveList() {
+    return const_cast<VirtualList*>(static_cast<const Game*>(this)->getActiveList());
+}
+
+const VirtualList* Game::getActiveList() const {
+    switch (currentState) {
+        case GameState::ACHIEVEMENTS: return &achievementList;
+        case GameState::STATISTICS: return &leaderboardList;
+        default: return nullptr;
+    }
+}
+
+sf::Time Game::getIdleTimeout() const {
+    // Wake up often enough to notice a background database connection,
+    // the next cursor blink and textures still being decoded.
+    float seconds = databaseOnline ? 1.0f : 0.25f;
+    
+    if (currentState == GameState::LOGIN) {
+        seconds = std::min(seconds, std::max(0.0f, cursorBlinkTime - cursorBlinkTimer));
+    }
+    if (ResourceCache::getInstance().getPendingCount() > 0) {
+        seconds = std::min(seconds, 0.016f);
+    }
+    if (glyphPrewarm && !glyphCache.isWarm()) {
+        seconds = std::min(seconds, 0.001f);
+    }
+    
+    return sf::seconds(seconds);
+}
+
+void Game::waitForActivity(sf::Time timeout) {
+    // SFML 2.5 has no waitEvent with a timeout, so sleep in short slices
+    // and wake on the first event.
+    sf::Clock waitClock;
+    sf::Event event;
+    while (window.isOpen() && waitClock.getElapsedTime() < timeout) {
+        if (window.pollEvent(event)) {
+            handleEvent(event);
+            return;
         }
+        sf::sleep(std::min(IDLE_POLL_SLICE, timeout - waitClock.getElapsedTime()));
     }
 }
 
@@ -261,16 +419,11 @@ void Game::handleTextInput(sf::Uint32 unicode) {
             }
     else if (currentState == GameState::MAIN_MENU) {
         if (unicode == '1' || unicode == 'q' || unicode == 'Q') {
-            currentState = GameState::SOLAR_SYSTEM;
-            currentButtons.clear();
-            currentButtons.push_back(GameUI::createButton(
-                "Back to Menu", 20, 20, 150, 40, GameState::MAIN_MENU
-            ));
+            switchState(GameState::SOLAR_SYSTEM);
         }
         else if (unicode == 27) {
-            currentState = GameState::LOGIN;
             resetLoginState();
-            currentButtons = loginButtons;
+            switchState(GameState::LOGIN);
         }
     }
 }
@@ -278,354 +431,99 @@ void Game::handleTextInput(sf::Uint32 unicode) {
 void Game::handleMouseClick(int x, int y) {
     updateButtonState(x, y);
     
-    if (currentState == GameState::LOGIN) {
-        for (auto& button : currentButtons) {
-            if (button.isPressed) {
-                if (button.text == "Login" && !playerNameInput.empty()) {
-                    GameDatabase::checkPlayerName(this, playerNameInput);
-                }
-                else if (button.text == "Register New Player" && !playerNameInput.empty()) {
-                    foundExistingPlayer = false;
-                    playerNameConfirmed = true;
-                    passwordEnterMode = true;
-                    confirmPasswordMode = false;
-                    playerPasswordInput = "";
-                    playerConfirmPasswordInput = "";
-                    
-                    currentButtons.clear();
-                    currentButtons.push_back(loginButtons[2]);
-                    currentButtons.push_back(loginButtons[3]);
-                }
-                else if (button.text == "Confirm Password") {
-                    if (passwordEnterMode && !playerPasswordInput.empty() && !confirmPasswordMode) {
-                        confirmPasswordMode = true;
-                        passwordEnterMode = false;
-                        playerConfirmPasswordInput = "";
-                    }
-                    else if (confirmPasswordMode && !playerConfirmPasswordInput.empty()) {
-                        if (playerPasswordInput == playerConfirmPasswordInput) {
-                            if (foundExistingPlayer) {
-                                GameDatabase::loadExistingPlayer(this);
-                            } else {
-                                GameDatabase::createNewPlayer(this, playerNameInput, playerPasswordInput);
-                            }
-                        } else {
-                            passwordEnterMode = true;
-                            confirmPasswordMode = false;
-                            playerPasswordInput = "";
-                            playerConfirmPasswordInput = "";
-                        }
-                    }
-                }
-                else if (button.text == "Back") {
-                    if (confirmPasswordMode) {
-                        confirmPasswordMode = false;
-                        passwordEnterMode = true;
-                        playerConfirmPasswordInput = "";
-                    }
-                    else if (passwordEnterMode) {
-                        passwordEnterMode = false;
-                        playerPasswordInput = "";
-                        playerNameConfirmed = false;
-                        foundExistingPlayer = false;
-                        
-                        currentButtons.clear();
-                        if (!playerNameInput.empty()) {
-                            currentButtons.push_back(loginButtons[0]);
-                            currentButtons.push_back(loginButtons[1]);
-                        }
-                        currentButtons.push_back(loginButtons[4]);
-                    }
-                    else if (playerNameConfirmed) {
-                        playerNameConfirmed = false;
-                        playerNameInput = "";
-                        foundExistingPlayer = false;
-                        
-                        currentButtons.clear();
-                        currentButtons.push_back(loginButtons[4]);
-                    }
-                }
-                else if (button.text == "Exit Game") {
-                    window.close();
-                }
-                break;
-            }
-        }
-    }
-
-    else if (currentState == GameState::SOLAR_SYSTEM) {
-        if (solarSystem) {
-            solarSystem->selectBodyAt(x, y);
-            CelestialBody* selectedBody = solarSystem->getSelectedBody();
-            
-            if (selectedBody) {
-                std::string planetName = selectedBody->getName();
-                
-                GameLogic::selectPlanet(this, planetName);
-            }
-        }
-        
-        for (auto& button : currentButtons) {
-            if (button.isPressed) {
-                executeButtonAction(button);
-                break;
-            }
-        }
-    }
-    else {
-        for (auto& button : currentButtons) {
-            if (button.isPressed) {
-                executeButtonAction(button);
-                break;
-            }
-        }
-    }
-}
-
-void Game::executeButtonAction(const Button& button) {
-    std::cout << "Button clicked: " << button.text << std::endl;
-    
-    if (button.text == "Exit" || button.text == "Exit Game") {
-        saveGame();
-        window.close();
-        return;
-    }
-    
-    if (button.text == "Exit Quiz") {
-        currentState = GameState::MAIN_MENU;
-        currentButtons = mainMenuButtons;
-        return;
-    }
-    
-    if (button.text == "Retry Incorrect Questions" && quiz) {
-        if (quiz->needsRetry() && !quiz->hasRetryMode()) {
-            int requiredCorrect = planetUnlockRequirement[selectedPlanet];
-            quiz->startRetryIncorrectQuestions(requiredCorrect);
-            currentState = GameState::QUIZ;
-            
-            quizButtons.clear();
-            quizButtons.push_back(GameUI::createButton(
-                "Next Question", 
-                362, 
-                550, 
-                300, 
-                50, 
-                GameState::QUIZ
-            ));
-            quizButtons.push_back(GameUI::createButton(
-                "Exit Quiz", 
-                362, 
-                610, 
-                300, 
-                50, 
-                GameState::MAIN_MENU
-            ));
-            quizButtons.push_back(GameUI::createButton(
-                "Return to " + selectedPlanet + " Info", 
-                362, 
-                670, 
-                300, 
-                50, 
-                GameState::PLANET_INFO
-            ));
-            
-            currentButtons = quizButtons;
-            
-            std::cout << "Started retry quiz with " << quiz->getCurrentRetryQuestionCount() 
-                      << " questions" << std::endl;
-        }
-        return;
-    }
-    
-    if (button.text.find("Quiz") != std::string::npos && !selectedPlanet.empty()) {
-        std::string quizPlanet = selectedPlanet;
-        if (button.text.find("Take ") == 0) {
-            size_t start = 5;
-            size_t end = button.text.find(" Quiz");
-            if (end != std::string::npos) {
-                quizPlanet = button.text.substr(start, end - start);
-            }
-        }
-        GameLogic::startPlanetQuiz(this, quizPlanet);
-        return;
-    }
-    
-    if (button.text == "Next Question" && quiz) {
-        if (quiz->hasAnsweredCurrent()) {
-            quiz->nextQuestion();
-        }
-        return;
-    }
-    
-    if (button.text == "Take Another Quiz") {
-        if (!selectedPlanet.empty() && GameLogic::isPlanetUnlocked(this, selectedPlanet)) {
-            GameLogic::startPlanetQuiz(this, selectedPlanet);
-        } else {
-            quiz->startNewQuiz("planets", 5);
-            currentState = GameState::QUIZ;
-            currentButtons = quizButtons;
+    // Bodies are picked on release, so a press that turns into a drag
+    // does not select anything.
+    if (hoveredButton < 0) {
+        if (currentState == GameState::SOLAR_SYSTEM) {
+            camera.beginDrag(sf::Vector2i(x, y));
         }
         return;
     }
     
-    if (button.text == "Back to Name Input") {
-        playerNameInput = "";
-        playerNameConfirmed = false;
-        passwordEnterMode = false;
-        confirmPasswordMode = false;
-        foundExistingPlayer = false;
-        
-        GameUI::initLoginScreen(this);
-        return;
-    }
-    
-    if (button.text == "Return to Solar System" || button.text == "Back to Solar System") {
-        currentState = GameState::SOLAR_SYSTEM;
-        currentButtons.clear();
-        currentButtons.push_back(GameUI::createButton(
-            "Back to Menu", 20, 20, 150, 40, GameState::MAIN_MENU
-        ));
-        return;
-    }
-    
-    if (button.text.find("Return to ") == 0 && button.text.find(" Info") != std::string::npos) {
-        currentState = GameState::PLANET_INFO;
+    executeButtonAction(layouts.getButton(currentLayout, hoveredButton));
+}
+
+void Game::handleMouseRelease(int x, int y) {
+    if (!camera.isDragging()) {
         return;
     }
-    
-    if (button.text == "Return to Menu") {
-        currentState = GameState::MAIN_MENU;
-        currentButtons = mainMenuButtons;
+    if (camera.endDrag() || currentState != GameState::SOLAR_SYSTEM || !solarSystem) {
         return;
     }
     
-    if (button.text == "Study More") {
-        if (player && !selectedPlanet.empty()) {
-            player->recordStudy(selectedPlanet, 60);
-        }
-        currentState = GameState::SOLAR_SYSTEM;
-        currentButtons.clear();
-        currentButtons.push_back(GameUI::createButton(
-            "Back to Menu", 20, 20, 150, 40, GameState::MAIN_MENU
-        ));
-        return;
-    }
+    // The first click on a body follows it, a second one opens its page.
+    CelestialBody* previous = solarSystem->getSelectedBody();
+    solarSystem->selectBodyAt(camera.screenToWorld(sf::Vector2i(x, y)), PICK_RADIUS_PIXELS / camera.getZoom());
+    CelestialBody* selectedBody = solarSystem->getSelectedBody();
     
-    if (button.text == "Back" || button.text == "Back to Menu") {
-        if (currentState == GameState::MAIN_MENU) {
-            currentState = GameState::LOGIN;
-            resetLoginState();
-            currentButtons = loginButtons;
-        } else {
-            currentState = GameState::MAIN_MENU;
-            currentButtons = mainMenuButtons;
-        }
-        return;
-    }
-    
-    if (button.text == "Solar System") {
-        currentState = GameState::SOLAR_SYSTEM;
-        currentButtons.clear();
-        currentButtons.push_back(GameUI::createButton(
-            "Back to Menu", 20, 20, 150, 40, GameState::MAIN_MENU
-        ));
-        return;
+    if (!selectedBody) {
+        camera.stopFollowing();
+    } else if (selectedBody == previous) {
+        GameLogic::selectPlanet(this, selectedBody->getName());
+    } else {
+        camera.follow();
     }
+}
+
+void Game::executeButtonAction(const UILayout::Button& button) {
+    std::cout << "Button clicked: " << button.label << std::endl;
+    GameActions::dispatch(this, button.action);
+    invalidateUI();
+}
+
+void Game::switchState(GameState state) {
+    currentState = state;
     
-    if (button.text == "Achievements") {
-        currentState = GameState::ACHIEVEMENTS;
-        currentButtons.clear();
-        currentButtons.push_back(GameUI::createButton(
-            "Back", 20, 20, 100, 40, GameState::MAIN_MENU
-        ));
-        return;
+    switch (state) {
+        case GameState::LOGIN:
+            setLayout(UILayout::Id::LOGIN_NAME);
+            break;
+        case GameState::MAIN_MENU:
+            setLayout(UILayout::Id::MAIN_MENU);
+            break;
+        case GameState::SOLAR_SYSTEM:
+            setLayout(UILayout::Id::SOLAR_SYSTEM);
+            break;
+        case GameState::QUIZ:
+            setLayout(selectedPlanet.empty() ? UILayout::Id::QUIZ_GENERAL : UILayout::Id::QUIZ);
+            break;
+        case GameState::PLANET_INFO:
+            GameUI::setupPlanetInfoButtons(this);
+            break;
+        case GameState::ACHIEVEMENTS:
+            achievementRows.reload(player.get());
+            achievementList.setSource(&achievementRows);
+            setLayout(UILayout::Id::BACK_ONLY);
+            break;
+        case GameState::STATISTICS:
+            leaderboard.reload(player ? player->getName() : "");
+            leaderboardList.setSource(&leaderboard);
+            setLayout(UILayout::Id::BACK_ONLY);
+            break;
     }
-    
-    if (button.text == "Statistics") {
-        currentState = GameState::STATISTICS;
-        currentButtons = statisticsButtons;
+}
+
+void Game::setLayout(UILayout::Id layout) {
+    if (layout == currentLayout) {
         return;
     }
     
-    if (currentState == GameState::LOGIN) {
-        if (button.text == "Continue" && !playerNameInput.empty()) {
-            GameDatabase::checkPlayerName(this, playerNameInput);
-            return;
-        }
-        else if (button.text == "Create New Player") {
-            GameDatabase::createNewPlayer(this, playerNameInput, playerPasswordInput);
-            return;
-        }
-        else if (button.text == "Load Existing Player") {
-            GameDatabase::loadExistingPlayer(this);
-            return;
-        }
-        else if (button.text == "Create New Instead") {
-            GameDatabase::createNewPlayer(this, playerNameInput, playerPasswordInput);
-            return;
-        }
-        else if (button.text == "Back") {
-            playerNameConfirmed = false;
-            playerNameInput = "";
-            foundExistingPlayer = false;
-            return;
-        }
-    }
-    
-    if (button.targetState != currentState) {
-        currentState = button.targetState;
-        
-        switch (currentState) {
-            case GameState::LOGIN:
-                currentButtons = loginButtons;
-                break;
-            case GameState::MAIN_MENU:
-                currentButtons = mainMenuButtons;
-                break;
-            case GameState::QUIZ:
-                if (selectedPlanet.empty()) {
-                    quiz->startNewQuiz("planets", 5);
-                }
-                currentButtons = quizButtons;
-                break;
-            case GameState::SOLAR_SYSTEM:
-                currentButtons.clear();
-                currentButtons.push_back(GameUI::createButton(
-                    "Back to Menu", 20, 20, 150, 40, GameState::MAIN_MENU
-                ));
-                break;
-            case GameState::PLANET_INFO:
-                currentButtons = planetInfoButtons;
-                break;
-            case GameState::ACHIEVEMENTS:
-            case GameState::STATISTICS:
-                currentButtons.clear();
-                currentButtons.push_back(GameUI::createButton(
-                    "Back", 20, 20, 100, 40, GameState::MAIN_MENU
-                ));
-                break;
-        }
-    }
+    currentLayout = layout;
+    hoveredButton = -1;
+    hoveredButtonPressed = false;
+    invalidateUI();
 }
 
 void Game::handleMouseMove(int x, int y) {
     updateButtonState(x, y);
+    if (camera.isDragging()) {
+        camera.dragTo(sf::Vector2i(x, y));
+    }
 }
 
 void Game::updateButtonState(int x, int y) {
-    for (auto& button : currentButtons) {
-        button.isHovered = false;
-        button.isPressed = false;
-        
-        if (x >= button.x && x <= button.x + button.width &&
-            y >= button.y && y <= button.y + button.height) {
-            button.isHovered = true;
-            
-            if (sf::Mouse::isButtonPressed(sf::Mouse::Left)) {
-                button.isPressed = true;
-            }
-        }
-    }
+    hoveredButton = layouts.hitTest(currentLayout, x, y);
+    hoveredButtonPressed = hoveredButton >= 0 && sf::Mouse::isButtonPressed(sf::Mouse::Left);
 }
 
 void Game::handleKeyPress(sf::Keyboard::Key key) {
@@ -651,39 +549,32 @@ void Game::handleKeyPress(sf::Keyboard::Key key) {
                     std::cout << "Cleared name input" << std::endl;
                 }
                 else {
-                    window.close();
+                    quit();
+                    break;
                 }
+                GameActions::showLoginLayout(this);
             }
             else if (currentState == GameState::QUIZ) {
                 if (quiz && !quiz->isFinished()) {
-                    currentState = GameState::PLANET_INFO;
-                    currentButtons = planetInfoButtons;
+                    switchState(GameState::PLANET_INFO);
                     std::cout << "Exited quiz via ESC" << std::endl;
                 } else {
-                    currentState = GameState::MAIN_MENU;
-                    currentButtons = mainMenuButtons;
+                    switchState(GameState::MAIN_MENU);
                 }
             }
             else if (currentState == GameState::SOLAR_SYSTEM) {
-                currentState = GameState::MAIN_MENU;
-                currentButtons = mainMenuButtons;
+                switchState(GameState::MAIN_MENU);
             }
             else if (currentState == GameState::PLANET_INFO) {
-                currentState = GameState::SOLAR_SYSTEM;
-                currentButtons.clear();
-                currentButtons.push_back(GameUI::createButton(
-                    "Back to Menu", 20, 20, 150, 40, GameState::MAIN_MENU
-                ));
+                switchState(GameState::SOLAR_SYSTEM);
             }
             else if (currentState == GameState::ACHIEVEMENTS || 
                      currentState == GameState::STATISTICS) {
-                currentState = GameState::MAIN_MENU;
-                currentButtons = mainMenuButtons;
+                switchState(GameState::MAIN_MENU);
             }
             else if (currentState == GameState::MAIN_MENU) {
-                currentState = GameState::LOGIN;
                 resetLoginState();
-                currentButtons = loginButtons;
+                switchState(GameState::LOGIN);
             }
             break;
             
@@ -714,7 +605,7 @@ void Game::handleKeyPress(sf::Keyboard::Key key) {
                     quiz->nextQuestion();
                     std::cout << "Moving to next question" << std::endl;
                 } else if (quiz->isFinished()) {
-                    currentButtons.clear();
+                    setLayout(UILayout::Id::EMPTY);
                 }
             }
             break;
@@ -784,31 +675,65 @@ void Game::handleKeyPress(sf::Keyboard::Key key) {
             
         case sf::Keyboard::F1:
             if (currentState != GameState::LOGIN) {
-                currentState = GameState::SOLAR_SYSTEM;
-                currentButtons.clear();
-                currentButtons.push_back(GameUI::createButton(
-                    "Back to Menu", 20, 20, 150, 40, GameState::MAIN_MENU
-                ));
+                switchState(GameState::SOLAR_SYSTEM);
             }
             break;
             
+        case sf::Keyboard::F3:
+            profiler.toggle();
+            break;
+            
         case sf::Keyboard::F4:
             if (currentState != GameState::LOGIN) {
-                currentState = GameState::ACHIEVEMENTS;
-                currentButtons.clear();
-                currentButtons.push_back(GameUI::createButton(
-                    "Back", 20, 20, 100, 40, GameState::MAIN_MENU
-                ));
+                switchState(GameState::ACHIEVEMENTS);
             }
             break;
             
         case sf::Keyboard::F5:
             if (currentState != GameState::LOGIN) {
-                currentState = GameState::STATISTICS;
-                currentButtons.clear();
-                currentButtons.push_back(GameUI::createButton(
-                    "Back", 20, 20, 100, 40, GameState::MAIN_MENU
-                ));
+                GameDatabase::refreshPlayerStatistics();
+                switchState(GameState::STATISTICS);
+            }
+            break;
+            
+        case sf::Keyboard::F10:
+            renderThread.getCapture().setRecording(!renderThread.getCapture().isRecording());
+            break;
+            
+        case sf::Keyboard::F12:
+            renderThread.getCapture().requestScreenshot();
+            requestRedraw();
+            break;
+            
+        case sf::Keyboard::Add:
+        case sf::Keyboard::Equal:
+            if (currentState == GameState::SOLAR_SYSTEM) {
+                timeScale = std::min(timeScale * 2.0f, MAX_TIME_SCALE);
+                std::cout << "Time scale: x" << timeScale << std::endl;
+            }
+            break;
+            
+        case sf::Keyboard::Subtract:
+        case sf::Keyboard::Hyphen:
+            if (currentState == GameState::SOLAR_SYSTEM) {
+                timeScale = std::max(timeScale / 2.0f, MIN_TIME_SCALE);
+                std::cout << "Time scale: x" << timeScale << std::endl;
+            }
+            break;
+            
+        case sf::Keyboard::Up:
+        case sf::Keyboard::Down:
+        case sf::Keyboard::PageUp:
+        case sf::Keyboard::PageDown:
+        case sf::Keyboard::Home:
+        case sf::Keyboard::End:
+            if (VirtualList* list = getActiveList()) {
+                list->handleKey(key);
+            } else if (key == sf::Keyboard::Home && currentState == GameState::SOLAR_SYSTEM) {
+                camera.reset();
+                if (solarSystem) {
+                    solarSystem->clearSelection();
+                }
             }
             break;
             
@@ -824,10 +749,53 @@ void Game::handleKeyPress(sf::Keyboard::Key key) {
     }
 }
 
+const char* Game::getStateName(GameState state) {
+    switch (state) {
+        case GameState::LOGIN: return "Login";
+        case GameState::MAIN_MENU: return "Main Menu";
+        case GameState::SOLAR_SYSTEM: return "Solar System";
+        case GameState::QUIZ: return "Quiz";
+        case GameState::PLANET_INFO: return "Planet Info";
+        case GameState::ACHIEVEMENTS: return "Achievements";
+        case GameState::STATISTICS: return "Statistics";
+    }
+    return "";
+}
+
+void Game::quit() {
+    renderThread.stop();
+    window.close();
+}
+
 void Game::render() {
-    window.clear(sf::Color(10, 10, 40));
+    DrawList& frame = renderThread.beginFrame();
     
-    window.draw(backgroundSprite);
+    {
+        FrameProfiler::Scope scope(profiler, FrameProfiler::RECORD);
+        recordFrame(frame);
+    }
+    glyphCache.noteFrame(frame);
+    
+    profiler.addTime(FrameProfiler::SUBMIT, renderThread.getSubmitTime());
+    profiler.addTime(FrameProfiler::DISPLAY, renderThread.getDisplayTime());
+    profiler.endFrame(getStateName(currentState), frame.size(), frame.getTextCount());
+    profiler.draw(frame, getFont(), sf::Vector2f(10.0f, 40.0f));
+    
+    renderThread.getPacer().endWork();
+    renderThread.publish();
+}
+
+void Game::recordFrame(DrawList& frame) {
+    currentFrame = &frame;
+    frame.setClearColor(sf::Color(10, 10, 40));
+    
+    starfield.draw(frame, camera.getCenter(), camera.getZoom());
+    frame.endScene();
+    
+    if (currentState != renderedState) {
+        renderedState = currentState;
+        invalidateUI();
+    }
     
     switch (currentState) {
         case GameState::LOGIN:
@@ -863,7 +831,7 @@ void Game::render() {
         GameStates::renderHUD(this);
     }
     
-    window.display();
+    currentFrame = nullptr;
 }
 
 void Game::saveGame() {
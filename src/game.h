@@ -10,13 +10,40 @@
 #include "quiz.h"
 #include "player.h"
 #include "database.h"
+#include "widget_tree.h"
+#include "starfield.h"
+#include "draw_list.h"
+#include "render_thread.h"
+#include "frame_profiler.h"
+#include "glyph_cache.h"
+#include "ui_layout.h"
+#include "text_layout.h"
+#include "virtual_list.h"
+#include "list_sources.h"
+#include "camera.h"
 
 class Game {
 public:
-    Game();
+    // Without a window the game can still build its content and record
+    // frames, as the headless render benchmark does.
+    explicit Game(bool createWindow = true);
     ~Game();
     
     bool init();
+    bool initContent(unsigned int seed);
+    void recordFrame(DrawList& frame);
+    void setGlyphPrewarm(bool enabled) { glyphPrewarm = enabled; }
+    
+    enum class ResolutionMode {
+        AUTO,
+        NATIVE,
+        DYNAMIC
+    };
+    
+    // AUTO scales the scene dynamically only on software GL.
+    void setResolutionMode(ResolutionMode mode) { resolutionMode = mode; }
+    // Before init().
+    void setFramePacing(FramePacer::Mode mode, int framesPerSecond) { renderThread.getPacer().setMode(mode, framesPerSecond); }
     void run();
     
     enum class GameState {
@@ -29,14 +56,6 @@ public:
         STATISTICS
     };
     
-    struct Button {
-        std::string text;
-        float x, y, width, height;
-        GameState targetState;
-        bool isHovered;
-        bool isPressed;
-    };
-    
     struct PlanetInfo {
         std::string name;
         std::string description;
@@ -57,21 +76,48 @@ public:
     int score = 0;
     int correctAnswers = 0;
     int totalQuestions = 0;
+    std::string unlockedPlanet;
     };
 
     QuizCompletionData lastQuizCompletion;
     
     sf::RenderWindow& getWindow() { return window; }
-    sf::Font& getFont() { return mainFont; }
-    sf::Sprite& getBackgroundSprite() { return backgroundSprite; }
+    DrawList& getFrame() { return *currentFrame; }
+    void quit();
+    sf::Font& getFont() { return *mainFont; }
+    TextLayoutCache& getTextLayouts() { return textLayouts; }
+    Starfield& getStarfield() { return starfield; }
     GameState getCurrentState() const { return currentState; }
+    static const char* getStateName(GameState state);
     void setCurrentState(GameState state) { currentState = state; }
+    // Enters a state with its default button layout.
+    void switchState(GameState state);
+    
+    const UILayout& getLayouts() const { return layouts; }
+    UILayout::Id getLayout() const { return currentLayout; }
+    void setLayout(UILayout::Id layout);
+    int getHoveredButton() const { return hoveredButton; }
+    bool isHoveredButtonPressed() const { return hoveredButtonPressed; }
+    
+    VirtualList& getLeaderboardList() { return leaderboardList; }
+    LeaderboardSource& getLeaderboard() { return leaderboard; }
+    VirtualList& getAchievementList() { return achievementList; }
+    AchievementSource& getAchievementRows() { return achievementRows; }
+    Camera& getCamera() { return camera; }
+    FrameCapture& getCapture() { return renderThread.getCapture(); }
+    
+    WidgetTree& getWidgetTree(GameState state) { return widgetTrees[state]; }
+    WidgetTree& getHudTree() { return hudTree; }
+    unsigned long getUIRevision() const { return uiRevision; }
+    void invalidateUI() { uiRevision++; frameDirty = true; }
+    void requestRedraw() { frameDirty = true; }
     
     std::string getSelectedPlanet() const { return selectedPlanet; }
     void setSelectedPlanet(const std::string& planet) { selectedPlanet = planet; }
     
     bool isPaused() const { return isPausedFlag; }
     void setPaused(bool paused) { isPausedFlag = paused; }
+    float getTimeScale() const { return timeScale; }
     
     float getDeltaTime() const { return deltaTime.asSeconds(); }
     float getCursorBlinkTimer() const { return cursorBlinkTimer; }
@@ -86,7 +132,6 @@ public:
     std::unique_ptr<Quiz>& getQuiz() { return quiz; }
     std::unique_ptr<SolarSystem>& getSolarSystem() { return solarSystem; }
     
-    std::vector<Button> currentButtons;
     std::map<std::string, bool> planetUnlockStatus;
     std::map<std::string, PlanetInfo> planetInfo;
     std::map<std::string, std::string> planetQuizCategory;
@@ -100,15 +145,18 @@ public:
     bool confirmPasswordMode;
     bool foundExistingPlayer;
     bool showCursor;
+    bool databaseOnline;
     ExistingPlayerData existingPlayerData;
     
     void handleEvents();
+    void handleEvent(const sf::Event& event);
     void handleKeyPress(sf::Keyboard::Key key);
     void handleTextInput(sf::Uint32 unicode);
     void handleMouseClick(int x, int y);
+    void handleMouseRelease(int x, int y);
     void handleMouseMove(int x, int y);
     void updateButtonState(int x, int y);
-    void executeButtonAction(const Button& button);
+    void executeButtonAction(const UILayout::Button& button);
     
     void saveGame();
     void loadGame();
@@ -117,17 +165,18 @@ public:
     
     std::string getBodyType(const std::string& bodyName);
 
-    std::vector<Button> loginButtons;
-    std::vector<Button> mainMenuButtons;
-    std::vector<Button> quizButtons;
-    std::vector<Button> planetInfoButtons;
-    std::vector<Button> statisticsButtons;
-
 private:
     sf::RenderWindow window;
-    sf::Font mainFont;
-    sf::Texture backgroundTexture;
-    sf::Sprite backgroundSprite;
+    RenderThread renderThread;
+    DrawList* currentFrame = nullptr;
+    FrameProfiler profiler;
+    GlyphCache glyphCache;
+    bool glyphPrewarm = true;
+    ResolutionMode resolutionMode = ResolutionMode::AUTO;
+    sf::Font fallbackFont;
+    sf::Font* mainFont = &fallbackFont;
+    TextLayoutCache textLayouts;
+    Starfield starfield;
     
     std::unique_ptr<SolarSystem> solarSystem;
     std::unique_ptr<Quiz> quiz;
@@ -145,7 +194,29 @@ private:
     
     std::string selectedPlanet;
     
+    UILayout layouts;
+    UILayout::Id currentLayout;
+    int hoveredButton;
+    bool hoveredButtonPressed;
+    
+    LeaderboardSource leaderboard;
+    AchievementSource achievementRows;
+    VirtualList leaderboardList{sf::FloatRect(50, 160, 960, 520), 90.0f, 2};
+    VirtualList achievementList{sf::FloatRect(62, 150, 900, 540), 60.0f};
+    Camera camera{sf::Vector2f(UILayout::SCREEN_WIDTH, UILayout::SCREEN_HEIGHT)};
+    
+    std::map<GameState, WidgetTree> widgetTrees;
+    WidgetTree hudTree;
+    unsigned long uiRevision;
+    GameState renderedState;
+    bool frameDirty;
+    
     void render();
+    bool isAnimating() const;
+    VirtualList* getActiveList();
+    const VirtualList* getActiveList() const;
+    sf::Time getIdleTimeout() const;
+    void waitForActivity(sf::Time timeout);
 };
 
 #endif
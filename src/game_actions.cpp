@@ -0,0 +1,203 @@
+#include "game_actions.h"
+#include "game_logic.h"
+#include "game_database.h"
+#include <iostream>
+
+void GameActions::dispatch(Game* game, UILayout::Action action) {
+    using Handler = void (*)(Game*);
+    static const Handler HANDLERS[] = {
+        &GameActions::none,
+        &GameActions::login,
+        &GameActions::registerPlayer,
+        &GameActions::confirmPassword,
+        &GameActions::loginBack,
+        &GameActions::loginInstead,
+        &GameActions::tryDifferentName,
+        &GameActions::exitGame,
+        &GameActions::openSolarSystem,
+        &GameActions::openAchievements,
+        &GameActions::openStatistics,
+        &GameActions::backToMenu,
+        &GameActions::nextQuestion,
+        &GameActions::exitQuiz,
+        &GameActions::returnToSolarSystem,
+        &GameActions::returnToPlanetInfo,
+        &GameActions::takePlanetQuiz,
+        &GameActions::takeAnotherQuiz,
+        &GameActions::retryIncorrect,
+        &GameActions::studyMore,
+    };
+    static_assert(sizeof(HANDLERS) / sizeof(HANDLERS[0]) == static_cast<size_t>(UILayout::Action::COUNT),
+                  "every UILayout::Action needs a handler");
+    
+    size_t index = static_cast<size_t>(action);
+    if (index < static_cast<size_t>(UILayout::Action::COUNT)) {
+        HANDLERS[index](game);
+    }
+}
+
+void GameActions::showLoginLayout(Game* game) {
+    if (game->passwordEnterMode || game->confirmPasswordMode) {
+        game->setLayout(UILayout::Id::LOGIN_PASSWORD);
+    } else {
+        game->setLayout(UILayout::Id::LOGIN_NAME);
+    }
+}
+
+void GameActions::none(Game*) {
+}
+
+void GameActions::login(Game* game) {
+    if (!game->playerNameInput.empty()) {
+        GameDatabase::checkPlayerName(game, game->playerNameInput);
+    }
+}
+
+void GameActions::registerPlayer(Game* game) {
+    if (game->playerNameInput.empty()) {
+        return;
+    }
+    
+    game->foundExistingPlayer = false;
+    game->playerNameConfirmed = true;
+    game->passwordEnterMode = true;
+    game->confirmPasswordMode = false;
+    game->playerPasswordInput = "";
+    game->playerConfirmPasswordInput = "";
+    showLoginLayout(game);
+}
+
+void GameActions::confirmPassword(Game* game) {
+    if (game->passwordEnterMode && !game->playerPasswordInput.empty() && !game->confirmPasswordMode) {
+        game->confirmPasswordMode = true;
+        game->passwordEnterMode = false;
+        game->playerConfirmPasswordInput = "";
+    }
+    else if (game->confirmPasswordMode && !game->playerConfirmPasswordInput.empty()) {
+        if (game->playerPasswordInput == game->playerConfirmPasswordInput) {
+            if (game->foundExistingPlayer) {
+                GameDatabase::loadExistingPlayer(game);
+            } else {
+                GameDatabase::createNewPlayer(game, game->playerNameInput, game->playerPasswordInput);
+            }
+            return;
+        }
+        
+        game->passwordEnterMode = true;
+        game->confirmPasswordMode = false;
+        game->playerPasswordInput = "";
+        game->playerConfirmPasswordInput = "";
+    }
+}
+
+void GameActions::loginBack(Game* game) {
+    if (game->confirmPasswordMode) {
+        game->confirmPasswordMode = false;
+        game->passwordEnterMode = true;
+        game->playerConfirmPasswordInput = "";
+    }
+    else if (game->passwordEnterMode) {
+        game->passwordEnterMode = false;
+        game->playerPasswordInput = "";
+        game->playerNameConfirmed = false;
+        game->foundExistingPlayer = false;
+    }
+    else if (game->playerNameConfirmed) {
+        game->playerNameConfirmed = false;
+        game->playerNameInput = "";
+        game->foundExistingPlayer = false;
+    }
+    showLoginLayout(game);
+}
+
+void GameActions::loginInstead(Game* game) {
+    login(game);
+}
+
+void GameActions::tryDifferentName(Game* game) {
+    game->playerNameInput = "";
+    game->playerNameConfirmed = false;
+    game->passwordEnterMode = false;
+    game->confirmPasswordMode = false;
+    game->foundExistingPlayer = false;
+    showLoginLayout(game);
+}
+
+void GameActions::exitGame(Game* game) {
+    game->saveGame();
+    game->quit();
+}
+
+void GameActions::openSolarSystem(Game* game) {
+    game->switchState(Game::GameState::SOLAR_SYSTEM);
+}
+
+void GameActions::openAchievements(Game* game) {
+    game->switchState(Game::GameState::ACHIEVEMENTS);
+}
+
+void GameActions::openStatistics(Game* game) {
+    GameDatabase::refreshPlayerStatistics();
+    game->switchState(Game::GameState::STATISTICS);
+}
+
+void GameActions::backToMenu(Game* game) {
+    game->switchState(Game::GameState::MAIN_MENU);
+}
+
+void GameActions::nextQuestion(Game* game) {
+    auto& quiz = game->getQuiz();
+    if (quiz && quiz->hasAnsweredCurrent()) {
+        quiz->nextQuestion();
+    }
+}
+
+void GameActions::exitQuiz(Game* game) {
+    game->switchState(Game::GameState::MAIN_MENU);
+}
+
+void GameActions::returnToSolarSystem(Game* game) {
+    game->switchState(Game::GameState::SOLAR_SYSTEM);
+}
+
+void GameActions::returnToPlanetInfo(Game* game) {
+    game->switchState(Game::GameState::PLANET_INFO);
+}
+
+void GameActions::takePlanetQuiz(Game* game) {
+    if (!game->getSelectedPlanet().empty()) {
+        GameLogic::startPlanetQuiz(game, game->getSelectedPlanet());
+    }
+}
+
+void GameActions::takeAnotherQuiz(Game* game) {
+    std::string planet = game->getSelectedPlanet();
+    if (!planet.empty() && GameLogic::isPlanetUnlocked(game, planet)) {
+        GameLogic::startPlanetQuiz(game, planet);
+    } else {
+        game->getQuiz()->startNewQuiz("planets", 5);
+        game->switchState(Game::GameState::QUIZ);
+    }
+}
+
+void GameActions::retryIncorrect(Game* game) {
+    auto& quiz = game->getQuiz();
+    if (!quiz || !quiz->needsRetry() || quiz->hasRetryMode()) {
+        return;
+    }
+    
+    int requiredCorrect = game->planetUnlockRequirement[game->getSelectedPlanet()];
+    quiz->startRetryIncorrectQuestions(requiredCorrect);
+    game->setCurrentState(Game::GameState::QUIZ);
+    game->setLayout(UILayout::Id::QUIZ_RETRY);
+    
+    std::cout << "Started retry quiz with " << quiz->getCurrentRetryQuestionCount() 
+              << " questions" << std::endl;
+}
+
+void GameActions::studyMore(Game* game) {
+    if (game->getPlayer() && !game->getSelectedPlanet().empty()) {
+        game->getPlayer()->recordStudy(game->getSelectedPlanet(), 60);
+    }
+    game->switchState(Game::GameState::SOLAR_SYSTEM);
+}
@@ -0,0 +1,38 @@
+#ifndef GAME_ACTIONS_H
+#define GAME_ACTIONS_H
+
+#include "game.h"
+
+// Handlers for UILayout button actions, dispatched by action ID through a
+// table indexed by UILayout::Action.
+class GameActions {
+public:
+    static void dispatch(Game* game, UILayout::Action action);
+    
+    // Name or password buttons, depending on the login step.
+    static void showLoginLayout(Game* game);
+
+private:
+    static void none(Game* game);
+    static void login(Game* game);
+    static void registerPlayer(Game* game);
+    static void confirmPassword(Game* game);
+    static void loginBack(Game* game);
+    static void loginInstead(Game* game);
+    static void tryDifferentName(Game* game);
+    static void exitGame(Game* game);
+    static void openSolarSystem(Game* game);
+    static void openAchievements(Game* game);
+    static void openStatistics(Game* game);
+    static void backToMenu(Game* game);
+    static void nextQuestion(Game* game);
+    static void exitQuiz(Game* game);
+    static void returnToSolarSystem(Game* game);
+    static void returnToPlanetInfo(Game* game);
+    static void takePlanetQuiz(Game* game);
+    static void takeAnotherQuiz(Game* game);
+    static void retryIncorrect(Game* game);
+    static void studyMore(Game* game);
+};
+
+#endif
@@ -9,10 +9,10 @@ void GameDatabase::checkPlayerName(Game* game, const std::string& name) {
     
     if (db.isConnected()) {
         try {
-            auto dbPlayerData = db.getPlayerByName(name);
+            auto profile = db.getPlayerProfile(name);
             
-            game->existingPlayerData.name = dbPlayerData.name;
-            game->existingPlayerData.score = dbPlayerData.totalScore;
+            game->existingPlayerData.name = profile.player.name;
+            game->existingPlayerData.score = profile.player.totalScore;
             
             game->foundExistingPlayer = true;
             game->playerNameConfirmed = true;
@@ -21,9 +21,7 @@ void GameDatabase::checkPlayerName(Game* game, const std::string& name) {
             game->playerPasswordInput = "";
             game->playerConfirmPasswordInput = "";
             
-            game->currentButtons.clear();
-            game->currentButtons.push_back(game->loginButtons[2]);
-            game->currentButtons.push_back(game->loginButtons[3]);
+            game->setLayout(UILayout::Id::LOGIN_PASSWORD);
             
         } catch (const std::exception& e) {
             std::cout << "Player '" << name << "' not found. Please register first." << std::endl;
@@ -36,6 +34,12 @@ void GameDatabase::checkPlayerName(Game* game, const std::string& name) {
 void GameDatabase::createNewPlayer(Game* game, const std::string& name, const std::string& password) {
     Database& db = Database::getInstance();
     
+    if (db.isConnected() && password.empty()) {
+        std::cout << "A password is required to register " << name << std::endl;
+        game->resetLoginState();
+        return;
+    }
+    
     if (db.isConnected()) {
         try {
             int result = db.createPlayer(name, password);
@@ -44,7 +48,8 @@ void GameDatabase::createNewPlayer(Game* game, const std::string& name, const st
                 game->getPlayer() = std::make_unique<Player>(name);
                 if (game->getPlayer()->initialize()) {
                     std::cout << "New player created: " << name << std::endl;
-                    finishLogin(game);
+                    game->getPlayer()->setAuthenticated(true);
+                    finishLogin(game, true);
                 } else {
                     std::cerr << "Failed to initialize new player" << std::endl;
                     game->resetLoginState();
@@ -55,49 +60,7 @@ void GameDatabase::createNewPlayer(Game* game, const std::string& name, const st
                 game->passwordEnterMode = false;
                 game->confirmPasswordMode = false;
                 
-                game->loginButtons.clear();
-                
-                float centerX = 1024 / 2.0f;
-                float startY = 350.0f;
-                
-                game->loginButtons.push_back(GameUI::createButton(
-                    "Player '" + name + "' already exists!",
-                    centerX - 200,
-                    startY - 60,
-                    400,
-                    40,
-                    Game::GameState::LOGIN
-                ));
-                game->loginButtons.back().isHovered = false;
-                
-                game->loginButtons.push_back(GameUI::createButton(
-                    "Login Instead",
-                    centerX - 150,
-                    startY,
-                    300,
-                    50,
-                    Game::GameState::LOGIN
-                ));
-                
-                game->loginButtons.push_back(GameUI::createButton(
-                    "Try Different Name",
-                    centerX - 150,
-                    startY + 70,
-                    300,
-                    50,
-                    Game::GameState::LOGIN
-                ));
-                
-                game->loginButtons.push_back(GameUI::createButton(
-                    "Exit Game",
-                    centerX - 150,
-                    startY + 140,
-                    300,
-                    50,
-                    Game::GameState::LOGIN
-                ));
-                
-                game->currentButtons = game->loginButtons;
+                game->setLayout(UILayout::Id::LOGIN_NAME_TAKEN);
                 
                 std::cout << "Player name already exists: " << name << std::endl;
             }
@@ -128,6 +91,7 @@ void GameDatabase::loadExistingPlayer(Game* game) {
         game->getPlayer() = std::make_unique<Player>(authenticatedPlayer.name);
         if (game->getPlayer()->initialize()) {
             std::cout << "Existing player loaded: " << game->getPlayer()->getName() << std::endl;
+            game->getPlayer()->setAuthenticated(true);
             finishLogin(game);
         } else {
             std::cerr << "Failed to load existing player" << std::endl;
@@ -142,9 +106,8 @@ void GameDatabase::loadExistingPlayer(Game* game) {
     }
 }
 
-void GameDatabase::finishLogin(Game* game) {
-    game->setCurrentState(Game::GameState::MAIN_MENU);
-    game->currentButtons = game->mainMenuButtons;
+void GameDatabase::finishLogin(Game* game, bool newAccount) {
+    game->switchState(Game::GameState::MAIN_MENU);
     
     if (game->getPlayer()) {
         game->cleanupOldSaves(game->getPlayer()->getName());
@@ -152,6 +115,10 @@ void GameDatabase::finishLogin(Game* game) {
     
     game->loadGame();
     
+    if (game->getPlayer() && Database::getInstance().isConnected()) {
+        game->getPlayer()->flushPendingResults(newAccount);
+    }
+    
     GameLogic::updatePlanetUnlockStatus(game);
     
     game->saveGame();
@@ -159,6 +126,42 @@ void GameDatabase::finishLogin(Game* game) {
     game->resetLoginState();
 }
 
+void GameDatabase::pollConnection(Game* game) {
+    if (game->databaseOnline || !Database::getInstance().isConnected()) {
+        return;
+    }
+    
+    game->databaseOnline = true;
+    game->invalidateUI();
+    std::cout << "Database connected successfully" << std::endl;
+    
+    if (game->getPlayer()) {
+        upgradeOfflineSession(game);
+    }
+}
+
+void GameDatabase::upgradeOfflineSession(Game* game) {
+    Player& player = *game->getPlayer();
+    if (player.isAuthenticated()) {
+        player.flushPendingResults(false);
+        return;
+    }
+    
+    // Offline play never proved who the player is, so nothing is uploaded
+    // until they log in or register with a password.
+    if (player.hasPendingResults()) {
+        std::cout << "Log in or register as " << player.getName() << " to upload "
+                  << player.getPendingResultsCount() << " quiz results played offline" << std::endl;
+    }
+}
+
+void GameDatabase::refreshPlayerStatistics() {
+    Database& db = Database::getInstance();
+    if (db.isConnected()) {
+        db.revalidateProfileCache();
+    }
+}
+
 std::vector<Database::PlayerData> GameDatabase::getAllPlayersFromDB() {
     Database& db = Database::getInstance();
     if (db.isConnected()) {
@@ -170,7 +173,7 @@ std::vector<Database::PlayerData> GameDatabase::getAllPlayersFromDB() {
 std::vector<Database::QuizResultData> GameDatabase::getPlayerQuizHistoryFromDB(const std::string& playerName) {
     Database& db = Database::getInstance();
     if (db.isConnected()) {
-        return db.getPlayerQuizHistory(playerName, 50);
+        return db.getPlayerFullQuizHistory(playerName);
     }
     return {};
 }
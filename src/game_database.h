@@ -8,8 +8,12 @@ public:
     static void checkPlayerName(Game* game, const std::string& name);
     static void createNewPlayer(Game* game, const std::string& name, const std::string& password);
     static void loadExistingPlayer(Game* game);
-    static void finishLogin(Game* game);
+    static void finishLogin(Game* game, bool newAccount = false);
     
+    static void pollConnection(Game* game);
+    static void upgradeOfflineSession(Game* game);
+    
+    static void refreshPlayerStatistics();
     static std::vector<Database::PlayerData> getAllPlayersFromDB();
     static std::vector<Database::QuizResultData> getPlayerQuizHistoryFromDB(const std::string& playerName);
 };
@@ -179,13 +179,7 @@ void GameLogic::initPlanetUnlockSystem(Game* game) {
 void GameLogic::selectPlanet(Game* game, const std::string& planetName) {
     game->setSelectedPlanet(planetName);
     
-    if (isPlanetUnlocked(game, planetName)) {
-        game->setCurrentState(Game::GameState::PLANET_INFO);
-        game->currentButtons = game->planetInfoButtons;
-    } else {
-        game->setCurrentState(Game::GameState::PLANET_INFO);
-        game->currentButtons = game->planetInfoButtons;
-    }
+    game->switchState(Game::GameState::PLANET_INFO);
 }
 
 void GameLogic::startPlanetQuiz(Game* game, const std::string& planetName) {
@@ -219,38 +213,13 @@ void GameLogic::startPlanetQuiz(Game* game, const std::string& planetName) {
         }
 
         game->lastQuizCompletion.processed = false;
+        game->lastQuizCompletion.unlockedPlanet.clear();
         
         game->getQuiz()->startNewQuiz(category, questionCount);
         game->getQuiz()->setRequiredCorrectAnswers(requiredCorrect);
         game->setCurrentState(Game::GameState::QUIZ);
         
-        game->quizButtons.clear();
-        game->quizButtons.push_back(GameUI::createButton(
-            "Next Question", 
-            362, 
-            500, 
-            300, 
-            50, 
-            Game::GameState::QUIZ
-        ));
-        game->quizButtons.push_back(GameUI::createButton(
-            "Exit Quiz", 
-            362, 
-            560, 
-            300, 
-            50, 
-            Game::GameState::MAIN_MENU
-        ));
-        game->quizButtons.push_back(GameUI::createButton(
-            "Return to " + planetName + " Info", 
-            362, 
-            620, 
-            300, 
-            50, 
-            Game::GameState::PLANET_INFO
-        ));
-        
-        game->currentButtons = game->quizButtons;
+        game->setLayout(UILayout::Id::QUIZ);
         
         std::cout << "Starting " << planetName << " quiz: " 
                   << questionCount << " questions from category '" << category << "'" << std::endl;
@@ -303,6 +272,49 @@ void GameLogic::unlockPlanet(Game* game, const std::string& planetName) {
     }
 }
 
+void GameLogic::processQuizCompletion(Game* game) {
+    auto& quiz = game->getQuiz();
+    if (!quiz || !quiz->isFinished() || game->getSelectedPlanet().empty() || !game->getPlayer()) {
+        return;
+    }
+    // The first pass offers a retry instead of finishing.
+    if (quiz->needsRetry() && !quiz->hasRetryMode()) {
+        return;
+    }
+    
+    auto result = quiz->getCurrentResult();
+    int requiredCorrect = quiz->hasRetryMode() ? quiz->getRequiredCorrectAnswers()
+                                               : game->planetUnlockRequirement[game->getSelectedPlanet()];
+    bool passed = result.correctAnswers >= requiredCorrect;
+    if (quiz->hasRetryMode() && !passed) {
+        return;
+    }
+    
+    auto& completion = game->lastQuizCompletion;
+    if (completion.processed && completion.planetName == game->getSelectedPlanet() &&
+        completion.score == result.score) {
+        return;
+    }
+    
+    completion.processed = true;
+    completion.planetName = game->getSelectedPlanet();
+    completion.score = result.score;
+    completion.correctAnswers = result.correctAnswers;
+    completion.totalQuestions = result.totalQuestions;
+    completion.unlockedPlanet.clear();
+    
+    game->getPlayer()->completeQuiz(result);
+    
+    if (passed) {
+        std::string nextPlanet = game->planetInfo[game->getSelectedPlanet()].nextPlanet;
+        if (!nextPlanet.empty() && !isPlanetUnlocked(game, nextPlanet)) {
+            unlockPlanet(game, nextPlanet);
+            completion.unlockedPlanet = nextPlanet;
+        }
+    }
+    game->invalidateUI();
+}
+
 void GameLogic::updatePlanetUnlockStatus(Game* game) {
     if (!game->getPlayer()) {
         return;
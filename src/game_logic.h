@@ -13,6 +13,9 @@ public:
     static bool isPlanetUnlocked(Game* game, const std::string& planetName);
     static bool canUnlockPlanet(Game* game, const std::string& planetName);
     static void unlockPlanet(Game* game, const std::string& planetName);
+    // Records a finished quiz and unlocks the next planet once per result;
+    // called from the update step so drawing the results has no side effects.
+    static void processQuizCompletion(Game* game);
     static void updatePlanetUnlockStatus(Game* game);
 };
 
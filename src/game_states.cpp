@@ -2,9 +2,45 @@
 #include "game_ui.h"
 #include "game_database.h"
 #include "game_logic.h"
+#include <sstream>
 
 void GameStates::renderLogin(Game* game) {
-    sf::RenderWindow& window = game->getWindow();
+    WidgetTree& tree = game->getWidgetTree(Game::GameState::LOGIN);
+    if (tree.isStale(game->getUIRevision())) {
+        tree.clear();
+        buildLogin(game, tree);
+        tree.markBuilt(game->getUIRevision());
+    }
+    GameUI::drawRetained(game, tree);
+}
+
+void GameStates::updateLoginCursor(Game* game) {
+    WidgetTree& tree = game->getWidgetTree(Game::GameState::LOGIN);
+    if (sf::Text* input = tree.find<sf::Text>("input")) {
+        input->setString(loginInputText(game));
+    }
+}
+
+std::string GameStates::loginInputText(Game* game) {
+    std::string displayText;
+    if (!game->playerNameConfirmed) {
+        displayText = game->playerNameInput;
+        if (game->passwordEnterMode) {
+            return displayText;
+        }
+    } else if (game->confirmPasswordMode) {
+        displayText = std::string(game->playerConfirmPasswordInput.length(), '*');
+    } else {
+        displayText = std::string(game->playerPasswordInput.length(), '*');
+    }
+    
+    if (game->getShowCursor()) {
+        displayText += "|";
+    }
+    return displayText;
+}
+
+void GameStates::buildLogin(Game* game, WidgetTree& tree) {
     sf::Font& font = game->getFont();
     
     sf::Text title;
@@ -15,7 +51,7 @@ void GameStates::renderLogin(Game* game) {
     title.setStyle(sf::Text::Bold);
     sf::FloatRect titleBounds = title.getLocalBounds();
     title.setPosition(1024/2.0f - titleBounds.width/2.0f, 100);
-    window.draw(title);
+    tree.add(title);
     
     if (!game->playerNameConfirmed) {
         sf::Text subtitle;
@@ -25,27 +61,22 @@ void GameStates::renderLogin(Game* game) {
         subtitle.setFillColor(sf::Color::White);
         sf::FloatRect subtitleBounds = subtitle.getLocalBounds();
         subtitle.setPosition(1024/2.0f - subtitleBounds.width/2.0f, 180);
-        window.draw(subtitle);
+        tree.add(subtitle);
         
         sf::RectangleShape inputBg(sf::Vector2f(600, 60));
         inputBg.setPosition(1024/2.0f - 300, 250);
         inputBg.setFillColor(sf::Color(30, 30, 60, 200));
         inputBg.setOutlineThickness(2);
         inputBg.setOutlineColor(sf::Color::White);
-        window.draw(inputBg);
-        
-        std::string displayText = game->playerNameInput;
-        if (game->getShowCursor() && !game->passwordEnterMode) {
-            displayText += "|";
-        }
+        tree.add(inputBg);
         
         sf::Text inputText;
         inputText.setFont(font);
-        inputText.setString(displayText);
+        inputText.setString(loginInputText(game));
         inputText.setCharacterSize(28);
         inputText.setFillColor(sf::Color::White);
         inputText.setPosition(1024/2.0f - 290, 260);
-        window.draw(inputText);
+        tree.add(inputText, "input");
         
         sf::Text instruction;
         instruction.setFont(font);
@@ -55,7 +86,7 @@ void GameStates::renderLogin(Game* game) {
         instruction.setLineSpacing(1.2f);
         sf::FloatRect instructionBounds = instruction.getLocalBounds();
         instruction.setPosition(1024/2.0f - instructionBounds.width/2.0f, 320);
-        window.draw(instruction);
+        tree.add(instruction);
         
     } else if (game->passwordEnterMode && !game->confirmPasswordMode) {
         sf::Text subtitle;
@@ -69,27 +100,22 @@ void GameStates::renderLogin(Game* game) {
         subtitle.setFillColor(sf::Color::White);
         sf::FloatRect subtitleBounds = subtitle.getLocalBounds();
         subtitle.setPosition(1024/2.0f - subtitleBounds.width/2.0f, 180);
-        window.draw(subtitle);
+        tree.add(subtitle);
         
         sf::RectangleShape inputBg(sf::Vector2f(600, 60));
         inputBg.setPosition(1024/2.0f - 300, 250);
         inputBg.setFillColor(sf::Color(30, 30, 60, 200));
         inputBg.setOutlineThickness(2);
         inputBg.setOutlineColor(sf::Color::White);
-        window.draw(inputBg);
-        
-        std::string displayText = std::string(game->playerPasswordInput.length(), '*');
-        if (game->getShowCursor()) {
-            displayText += "|";
-        }
+        tree.add(inputBg);
         
         sf::Text inputText;
         inputText.setFont(font);
-        inputText.setString(displayText);
+        inputText.setString(loginInputText(game));
         inputText.setCharacterSize(28);
         inputText.setFillColor(sf::Color::White);
         inputText.setPosition(1024/2.0f - 290, 260);
-        window.draw(inputText);
+        tree.add(inputText, "input");
         
         sf::Text instruction;
         instruction.setFont(font);
@@ -103,7 +129,7 @@ void GameStates::renderLogin(Game* game) {
         instruction.setLineSpacing(1.2f);
         sf::FloatRect instructionBounds = instruction.getLocalBounds();
         instruction.setPosition(1024/2.0f - instructionBounds.width/2.0f, 320);
-        window.draw(instruction);
+        tree.add(instruction);
         
     } else if (game->confirmPasswordMode) {
         sf::Text subtitle;
@@ -113,27 +139,22 @@ void GameStates::renderLogin(Game* game) {
         subtitle.setFillColor(sf::Color::White);
         sf::FloatRect subtitleBounds = subtitle.getLocalBounds();
         subtitle.setPosition(1024/2.0f - subtitleBounds.width/2.0f, 180);
-        window.draw(subtitle);
+        tree.add(subtitle);
         
         sf::RectangleShape inputBg(sf::Vector2f(600, 60));
         inputBg.setPosition(1024/2.0f - 300, 250);
         inputBg.setFillColor(sf::Color(30, 30, 60, 200));
         inputBg.setOutlineThickness(2);
         inputBg.setOutlineColor(sf::Color::White);
-        window.draw(inputBg);
-        
-        std::string displayText = std::string(game->playerConfirmPasswordInput.length(), '*');
-        if (game->getShowCursor()) {
-            displayText += "|";
-        }
+        tree.add(inputBg);
         
         sf::Text inputText;
         inputText.setFont(font);
-        inputText.setString(displayText);
+        inputText.setString(loginInputText(game));
         inputText.setCharacterSize(28);
         inputText.setFillColor(sf::Color::White);
         inputText.setPosition(1024/2.0f - 290, 260);
-        window.draw(inputText);
+        tree.add(inputText, "input");
         
         sf::Text instruction;
         instruction.setFont(font);
@@ -143,12 +164,10 @@ void GameStates::renderLogin(Game* game) {
         instruction.setLineSpacing(1.2f);
         sf::FloatRect instructionBounds = instruction.getLocalBounds();
         instruction.setPosition(1024/2.0f - instructionBounds.width/2.0f, 320);
-        window.draw(instruction);
+        tree.add(instruction);
     }
     
-    for (const auto& button : game->currentButtons) {
-        GameUI::drawButton(button, window, font);
-    }
+    GameUI::addButtons(game, tree);
     
     sf::Text footer;
     footer.setFont(font);
@@ -164,11 +183,21 @@ void GameStates::renderLogin(Game* game) {
     footer.setFillColor(sf::Color(150, 150, 150));
     sf::FloatRect footerBounds = footer.getLocalBounds();
     footer.setPosition(1024/2.0f - footerBounds.width/2.0f, 680);
-    window.draw(footer);
+    tree.add(footer);
 }
 
 void GameStates::renderMainMenu(Game* game) {
-    sf::RenderWindow& window = game->getWindow();
+    WidgetTree& tree = game->getWidgetTree(Game::GameState::MAIN_MENU);
+    long long dataKey = game->getPlayer() ? game->getPlayer()->getScore() : -1;
+    if (tree.isStale(game->getUIRevision(), dataKey)) {
+        tree.clear();
+        buildMainMenu(game, tree);
+        tree.markBuilt(game->getUIRevision(), dataKey);
+    }
+    GameUI::drawRetained(game, tree);
+}
+
+void GameStates::buildMainMenu(Game* game, WidgetTree& tree) {
     sf::Font& font = game->getFont();
     
     if (game->getPlayer()) {
@@ -181,7 +210,7 @@ void GameStates::renderMainMenu(Game* game) {
         playerInfo.setStyle(sf::Text::Bold);
         sf::FloatRect infoBounds = playerInfo.getLocalBounds();
         playerInfo.setPosition(1024/2.0f - infoBounds.width/2.0f, 30);
-        window.draw(playerInfo);
+        tree.add(playerInfo);
     }
     
     sf::Text title;
@@ -192,7 +221,7 @@ void GameStates::renderMainMenu(Game* game) {
     title.setStyle(sf::Text::Bold);
     sf::FloatRect titleBounds = title.getLocalBounds();
     title.setPosition(1024/2.0f - titleBounds.width/2.0f, 120);
-    window.draw(title);
+    tree.add(title);
     
     sf::Text subtitle;
     subtitle.setFont(font);
@@ -201,19 +230,32 @@ void GameStates::renderMainMenu(Game* game) {
     subtitle.setFillColor(sf::Color::White);
     sf::FloatRect subtitleBounds = subtitle.getLocalBounds();
     subtitle.setPosition(1024/2.0f - subtitleBounds.width/2.0f, 200);
-    window.draw(subtitle);
+    tree.add(subtitle);
     
-    for (const auto& button : game->currentButtons) {
-        GameUI::drawButton(button, window, font);
-    }
+    GameUI::addButtons(game, tree);
 }
 
 void GameStates::renderSolarSystem(Game* game) {
-    sf::RenderWindow& window = game->getWindow();
+    DrawList& frame = game->getFrame();
     sf::Font& font = game->getFont();
     
-    if (game->getSolarSystem()) {
-        game->getSolarSystem()->draw(window);
+    SolarSystem* solarSystem = game->getSolarSystem().get();
+    Camera& camera = game->getCamera();
+    
+    if (solarSystem) {
+        solarSystem->placeBodies();
+        if (CelestialBody* selected = solarSystem->getSelectedBody()) {
+            camera.track(selected->getDisplayPosition());
+        }
+        
+        frame.changeView(camera.getView());
+        solarSystem->draw(frame, camera);
+        frame.changeView(frame.getView());
+    }
+    frame.endScene();
+    
+    if (solarSystem) {
+        solarSystem->drawLabels(frame, camera);
     }
     
     sf::Text title;
@@ -222,7 +264,7 @@ void GameStates::renderSolarSystem(Game* game) {
     title.setCharacterSize(24);
     title.setFillColor(sf::Color::Yellow);
     title.setPosition(20, 60);
-    window.draw(title);
+    frame.draw(title);
     
     int unlockedCount = 0;
     for (const auto& [name, unlocked] : game->planetUnlockStatus) {
@@ -231,15 +273,16 @@ void GameStates::renderSolarSystem(Game* game) {
     
     sf::Text instruction;
     instruction.setFont(font);
-    instruction.setString("Click on celestial bodies to learn more and take quizzes\n"
+    instruction.setString("Click a body to follow it, click it again to learn more and take quizzes\n"
+                         "Scroll to zoom, drag to pan, Home to reset the view\n"
                          "Unlocked bodies: " + std::to_string(unlockedCount) + "/" + 
                          std::to_string(game->planetUnlockStatus.size()));
     instruction.setCharacterSize(18);
     instruction.setFillColor(sf::Color(200, 200, 200));
     instruction.setPosition(20, 90);
-    window.draw(instruction);
+    frame.draw(instruction);
     
-    float startY = 130.0f;
+    float startY = 156.0f;
     sf::Text unlockInfo;
     unlockInfo.setFont(font);
     unlockInfo.setCharacterSize(16);
@@ -260,11 +303,9 @@ void GameStates::renderSolarSystem(Game* game) {
     }
     
     unlockInfo.setString(unlockText);
-    window.draw(unlockInfo);
+    frame.draw(unlockInfo);
     
-    for (const auto& button : game->currentButtons) {
-        GameUI::drawButton(button, window, font);
-    }
+    GameUI::drawButtons(game);
     
     if (game->isPaused()) {
         sf::Text pause;
@@ -275,12 +316,12 @@ void GameStates::renderSolarSystem(Game* game) {
         pause.setStyle(sf::Text::Bold);
         sf::FloatRect pauseBounds = pause.getLocalBounds();
         pause.setPosition(1024/2.0f - pauseBounds.width/2.0f, 384);
-        window.draw(pause);
+        frame.draw(pause);
     }
 }
 
 void GameStates::renderQuiz(Game* game) {
-    sf::RenderWindow& window = game->getWindow();
+    DrawList& frame = game->getFrame();
     sf::Font& font = game->getFont();
     
     if (!game->getQuiz()) {
@@ -297,7 +338,7 @@ void GameStates::renderQuiz(Game* game) {
             title.setStyle(sf::Text::Bold);
             sf::FloatRect titleBounds = title.getLocalBounds();
             title.setPosition(1024.0f / 2.0f - titleBounds.width / 2.0f, 100.0f);
-            window.draw(title);
+            frame.draw(title);
             
             int correctCount = 0;
             int totalQuestions = game->getQuiz()->getTotalQuestions();
@@ -324,7 +365,7 @@ void GameStates::renderQuiz(Game* game) {
             resultText.setLineSpacing(1.3f);
             sf::FloatRect resultBounds = resultText.getLocalBounds();
             resultText.setPosition(1024.0f / 2.0f - resultBounds.width / 2.0f, 180.0f);
-            window.draw(resultText);
+            frame.draw(resultText);
             
             float startY = 350.0f;
             sf::Text incorrectTitle;
@@ -333,7 +374,7 @@ void GameStates::renderQuiz(Game* game) {
             incorrectTitle.setCharacterSize(22);
             incorrectTitle.setFillColor(sf::Color::Red);
             incorrectTitle.setPosition(100.0f, startY);
-            window.draw(incorrectTitle);
+            frame.draw(incorrectTitle);
             
             startY += 40.0f;
             int incorrectCount = 0;
@@ -341,32 +382,22 @@ void GameStates::renderQuiz(Game* game) {
                 if (userAnswers[i] != questions[i].correctAnswer) {
                     incorrectCount++;
                     
-                    sf::Text questionText;
-                    questionText.setFont(font);
-                    sf::String displayText = sf::String(std::to_string(incorrectCount)) + ". " + sf::String(questions[i].text);
-                    questionText.setString(displayText);
-                    questionText.setCharacterSize(18);
-                    questionText.setFillColor(sf::Color(255, 200, 200));
-                    questionText.setPosition(120.0f, startY);
-                    
-                    sf::FloatRect bounds = questionText.getLocalBounds();
-                    if (bounds.width > 800.0f) {
-                        questionText.setScale(800.0f / bounds.width, 1.0f);
-                    }
+                    TextLayoutCache::Style retryStyle;
+                    retryStyle.characterSize = 18;
+                    retryStyle.maxWidth = 800.0f;
+                    retryStyle.color = sf::Color(255, 200, 200);
                     
-                    window.draw(questionText);
-                    startY += 30.0f;
+                    TextLayout questionText = game->getTextLayouts().get(
+                        TextLayoutCache::makeId(questions[i].id, QUESTION_RETRY_ITEM + incorrectCount),
+                        questions[i].text, retryStyle, std::to_wstring(incorrectCount) + L". ");
+                    questionText.setPosition(120.0f, startY);
+                    frame.draw(questionText);
+                    startY += questionText.getLocalBounds().height + 8.0f;
                 }
             }
             
-            game->currentButtons.clear();
-            game->currentButtons.push_back(GameUI::createButton("Retry Incorrect Questions", 362.0f, 550.0f, 300.0f, 50.0f, Game::GameState::QUIZ));
-            game->currentButtons.push_back(GameUI::createButton("Exit Quiz", 362.0f, 610.0f, 300.0f, 50.0f, Game::GameState::MAIN_MENU));
-            game->currentButtons.push_back(GameUI::createButton("Return to Planet Info", 362.0f, 670.0f, 300.0f, 50.0f, Game::GameState::PLANET_INFO));
-            
-            for (const auto& button : game->currentButtons) {
-                GameUI::drawButton(button, window, font);
-            }
+            game->setLayout(UILayout::Id::QUIZ_RETRY_OFFER);
+            GameUI::drawButtons(game);
             
             return;
         }
@@ -382,7 +413,7 @@ void GameStates::renderQuiz(Game* game) {
             title.setStyle(sf::Text::Bold);
             sf::FloatRect titleBounds = title.getLocalBounds();
             title.setPosition(1024.0f / 2.0f - titleBounds.width / 2.0f, 100.0f);
-            window.draw(title);
+            frame.draw(title);
             
             int requiredCorrect = game->getQuiz()->getRequiredCorrectAnswers();
             
@@ -406,41 +437,23 @@ void GameStates::renderQuiz(Game* game) {
             resultText.setLineSpacing(1.2f);
             sf::FloatRect resultBounds = resultText.getLocalBounds();
             resultText.setPosition(1024.0f / 2.0f - resultBounds.width / 2.0f, 180.0f);
-            window.draw(resultText);
+            frame.draw(resultText);
             
-            if (!game->getSelectedPlanet().empty() && game->getPlayer() && result.correctAnswers >= requiredCorrect) {
-                if (!game->lastQuizCompletion.processed || 
-                    game->lastQuizCompletion.planetName != game->getSelectedPlanet() ||
-                    game->lastQuizCompletion.score != result.score) {
-                    
-                    game->lastQuizCompletion.processed = true;
-                    game->lastQuizCompletion.planetName = game->getSelectedPlanet();
-                    game->lastQuizCompletion.score = result.score;
-                    game->lastQuizCompletion.correctAnswers = result.correctAnswers;
-                    game->lastQuizCompletion.totalQuestions = result.totalQuestions;
-                    
-                    game->getPlayer()->completeQuiz(result);
-                    
-                    std::string nextPlanet = game->planetInfo[game->getSelectedPlanet()].nextPlanet;
-                    if (!nextPlanet.empty() && !GameLogic::isPlanetUnlocked(game, nextPlanet)) {
-                        GameLogic::unlockPlanet(game, nextPlanet);
-                        
-                        sf::Text unlockText;
-                        unlockText.setFont(font);
-                        unlockText.setString("Congratulations!\nYou unlocked " + nextPlanet + "!");
-                        unlockText.setCharacterSize(24);
-                        unlockText.setFillColor(sf::Color::Green);
-                        unlockText.setLineSpacing(1.3f);
-                        sf::FloatRect unlockBounds = unlockText.getLocalBounds();
-                        unlockText.setPosition(1024.0f / 2.0f - unlockBounds.width / 2.0f, 300.0f);
-                        window.draw(unlockText);
-                    }
-                }
+            const auto& completion = game->lastQuizCompletion;
+            if (completion.processed && !completion.unlockedPlanet.empty()) {
+                sf::Text unlockText;
+                unlockText.setFont(font);
+                unlockText.setString("Congratulations!\nYou unlocked " + completion.unlockedPlanet + "!");
+                unlockText.setCharacterSize(24);
+                unlockText.setFillColor(sf::Color::Green);
+                unlockText.setLineSpacing(1.3f);
+                sf::FloatRect unlockBounds = unlockText.getLocalBounds();
+                unlockText.setPosition(1024.0f / 2.0f - unlockBounds.width / 2.0f, 300.0f);
+                frame.draw(unlockText);
             }
             
-            game->currentButtons.clear();
-            game->currentButtons.push_back(GameUI::createButton("Return to Solar System", 362.0f, 450.0f, 300.0f, 50.0f, Game::GameState::SOLAR_SYSTEM));
-            GameUI::drawButton(game->currentButtons[0], window, font);
+            game->setLayout(UILayout::Id::QUIZ_RETRY_RESULTS);
+            GameUI::drawButtons(game);
             return;
         }
         
@@ -454,7 +467,7 @@ void GameStates::renderQuiz(Game* game) {
         title.setStyle(sf::Text::Bold);
         sf::FloatRect titleBounds = title.getLocalBounds();
         title.setPosition(1024.0f / 2.0f - titleBounds.width / 2.0f, 100.0f);
-        window.draw(title);
+        frame.draw(title);
     
         float accuracy = 0.0f;
         if (result.totalQuestions > 0) {
@@ -472,52 +485,44 @@ void GameStates::renderQuiz(Game* game) {
         resultText.setLineSpacing(1.2f);
         sf::FloatRect resultBounds = resultText.getLocalBounds();
         resultText.setPosition(1024.0f / 2.0f - resultBounds.width / 2.0f, 180.0f);
-        window.draw(resultText);
-    
-        if (!game->getSelectedPlanet().empty() && game->getPlayer()) {
-            if (!game->lastQuizCompletion.processed || 
-                game->lastQuizCompletion.planetName != game->getSelectedPlanet() ||
-                game->lastQuizCompletion.score != result.score) {
-                
-                game->lastQuizCompletion.processed = true;
-                game->lastQuizCompletion.planetName = game->getSelectedPlanet();
-                game->lastQuizCompletion.score = result.score;
-                game->lastQuizCompletion.correctAnswers = result.correctAnswers;
-                game->lastQuizCompletion.totalQuestions = result.totalQuestions;
-                
-                game->getPlayer()->completeQuiz(result);
-                
-                int requiredCorrect = game->planetUnlockRequirement[game->getSelectedPlanet()];
-                if (result.correctAnswers >= requiredCorrect) {
-                    std::string nextPlanet = game->planetInfo[game->getSelectedPlanet()].nextPlanet;
-                    if (!nextPlanet.empty() && !GameLogic::isPlanetUnlocked(game, nextPlanet)) {
-                        GameLogic::unlockPlanet(game, nextPlanet);
-                        
-                        sf::Text unlockText;
-                        unlockText.setFont(font);
-                        unlockText.setString("Congratulations!\nYou unlocked " + nextPlanet + "!");
-                        unlockText.setCharacterSize(24);
-                        unlockText.setFillColor(sf::Color::Green);
-                        unlockText.setLineSpacing(1.3f);
-                        sf::FloatRect unlockBounds = unlockText.getLocalBounds();
-                        unlockText.setPosition(1024.0f / 2.0f - unlockBounds.width / 2.0f, 280.0f);
-                        window.draw(unlockText);
-                    }
-                }
-            }
+        frame.draw(resultText);
+    
+        const auto& completion = game->lastQuizCompletion;
+        if (completion.processed && !completion.unlockedPlanet.empty()) {
+            sf::Text unlockText;
+            unlockText.setFont(font);
+            unlockText.setString("Congratulations!\nYou unlocked " + completion.unlockedPlanet + "!");
+            unlockText.setCharacterSize(24);
+            unlockText.setFillColor(sf::Color::Green);
+            unlockText.setLineSpacing(1.3f);
+            sf::FloatRect unlockBounds = unlockText.getLocalBounds();
+            unlockText.setPosition(1024.0f / 2.0f - unlockBounds.width / 2.0f, 280.0f);
+            frame.draw(unlockText);
         }
     
-        game->currentButtons.clear();
-        game->currentButtons.push_back(GameUI::createButton("Return to Solar System", 362.0f, 350.0f, 300.0f, 50.0f, Game::GameState::SOLAR_SYSTEM));
-        game->currentButtons.push_back(GameUI::createButton("Take Another Quiz", 362.0f, 410.0f, 300.0f, 50.0f, Game::GameState::QUIZ));
-    
-        for (const auto& button : game->currentButtons) {
-            GameUI::drawButton(button, window, font);
-        }
+        game->setLayout(UILayout::Id::QUIZ_RESULTS);
+        GameUI::drawButtons(game);
         return;
     }
     
-    auto currentQuestion = game->getQuiz()->getCurrentQuestion();
+    int questionIndex = game->getQuiz()->getCurrentQuestionIndex();
+    int userAnswer = game->getQuiz()->hasAnsweredCurrent() ? game->getQuiz()->getLastAnswer() : -1;
+    long long dataKey = questionIndex * 8LL + userAnswer + 2;
+    
+    WidgetTree& tree = game->getWidgetTree(Game::GameState::QUIZ);
+    if (tree.isStale(game->getUIRevision(), dataKey)) {
+        tree.clear();
+        buildQuizQuestion(game, tree);
+        tree.markBuilt(game->getUIRevision(), dataKey);
+    }
+    tree.draw(frame);
+}
+
+void GameStates::buildQuizQuestion(Game* game, WidgetTree& tree) {
+    sf::Font& font = game->getFont();
+    TextLayoutCache& layouts = game->getTextLayouts();
+    
+    const Quiz::Question& currentQuestion = game->getQuiz()->getCurrentQuestion();
     int questionIndex = game->getQuiz()->getCurrentQuestionIndex() + 1;
     int totalQuestions = game->getQuiz()->getTotalQuestions();
     
@@ -532,73 +537,63 @@ void GameStates::renderQuiz(Game* game) {
     title.setFillColor(sf::Color::Yellow);
     sf::FloatRect titleBounds = title.getLocalBounds();
     title.setPosition(1024.0f / 2.0f - titleBounds.width / 2.0f, 50.0f);
-    window.draw(title);
+    tree.add(title);
     
-    sf::Text question;
-    question.setFont(font);
-    question.setString(currentQuestion.text);
-    question.setCharacterSize(24);
-    question.setFillColor(sf::Color::White);
-    question.setLineSpacing(1.2f);
+    TextLayoutCache::Style questionStyle;
+    questionStyle.characterSize = 24;
+    questionStyle.maxWidth = 900.0f;
+    questionStyle.lineSpacing = 1.2f;
+    questionStyle.centered = true;
     
+    TextLayout question = layouts.get(TextLayoutCache::makeId(currentQuestion.id, QUESTION_TEXT),
+                                      currentQuestion.text, questionStyle);
     sf::FloatRect questionBounds = question.getLocalBounds();
-    float maxWidth = 900.0f;
-    if (questionBounds.width > maxWidth) {
-        question.setScale(maxWidth / questionBounds.width, 1.0f);
-        questionBounds = question.getLocalBounds();
-    }
-    
     question.setPosition(1024.0f / 2.0f - questionBounds.width / 2.0f, 120.0f);
-    window.draw(question);
+    tree.add(question);
     
     bool hasAnswered = game->getQuiz()->hasAnsweredCurrent();
     int userAnswer = game->getQuiz()->getLastAnswer();
     
-    float startY = 200.0f;
+    // Options start below a wrapped question instead of overlapping it.
+    float startY = std::max(200.0f, 120.0f + questionBounds.height + 30.0f);
     for (size_t i = 0; i < currentQuestion.options.size(); ++i) {
-        sf::Text option;
-        option.setFont(font);
-        sf::String displayText = sf::String(std::to_string(i + 1)) + ". " + sf::String(currentQuestion.options[i]);
-        option.setString(displayText);
-        option.setCharacterSize(22);
+        TextLayoutCache::Style optionStyle;
+        optionStyle.characterSize = 22;
+        optionStyle.maxWidth = 900.0f;
+        optionStyle.lineSpacing = 1.1f;
         
         if (hasAnswered) {
             if (static_cast<int>(i) == currentQuestion.correctAnswer) {
-                option.setFillColor(sf::Color::Green);
+                optionStyle.color = sf::Color::Green;
             } else if (static_cast<int>(i) == userAnswer) {
-                option.setFillColor(sf::Color::Red);
+                optionStyle.color = sf::Color::Red;
             } else {
-                option.setFillColor(sf::Color(150, 150, 150));
+                optionStyle.color = sf::Color(150, 150, 150);
             }
-        } else {
-            option.setFillColor(sf::Color::White);
         }
         
-        option.setLineSpacing(1.1f);
+        TextLayout option = layouts.get(TextLayoutCache::makeId(currentQuestion.id, QUESTION_OPTION + i),
+                                        currentQuestion.options[i], optionStyle,
+                                        std::to_wstring(i + 1) + L". ");
         sf::FloatRect optionBounds = option.getLocalBounds();
-        option.setPosition(1024.0f / 2.0f - optionBounds.width / 2.0f, startY + i * 45.0f);
-        window.draw(option);
+        option.setPosition(1024.0f / 2.0f - optionBounds.width / 2.0f, startY);
+        tree.add(option);
+        startY += std::max(45.0f, optionBounds.height + 15.0f);
     }
     
     if (hasAnswered) {
-        sf::Text explanation;
-        explanation.setFont(font);
-        
-        sf::String displayText = sf::String("Explanation: " + sf::String(currentQuestion.explanation));
-        explanation.setString(displayText);
-        explanation.setCharacterSize(20);
-        explanation.setFillColor(sf::Color(200, 200, 255));
-        explanation.setLineSpacing(1.1f);
-        
+        TextLayoutCache::Style explanationStyle;
+        explanationStyle.characterSize = 20;
+        explanationStyle.maxWidth = 900.0f;
+        explanationStyle.lineSpacing = 1.1f;
+        explanationStyle.color = sf::Color(200, 200, 255);
+        explanationStyle.centered = true;
+        
+        TextLayout explanation = layouts.get(TextLayoutCache::makeId(currentQuestion.id, QUESTION_EXPLANATION),
+                                             currentQuestion.explanation, explanationStyle, L"Explanation: ");
         sf::FloatRect explanationBounds = explanation.getLocalBounds();
-        float explanationMaxWidth = 900.0f;
-        if (explanationBounds.width > explanationMaxWidth) {
-            explanation.setScale(explanationMaxWidth / explanationBounds.width, 1.0f);
-            explanationBounds = explanation.getLocalBounds();
-        }
-        
         explanation.setPosition(1024.0f / 2.0f - explanationBounds.width / 2.0f, 400.0f);
-        window.draw(explanation);
+        tree.add(explanation);
         
         sf::Text feedback;
         feedback.setFont(font);
@@ -613,7 +608,7 @@ void GameStates::renderQuiz(Game* game) {
         feedback.setCharacterSize(24);
         sf::FloatRect feedbackBounds = feedback.getLocalBounds();
         feedback.setPosition(1024.0f / 2.0f - feedbackBounds.width / 2.0f, 360.0f);
-        window.draw(feedback);
+        tree.add(feedback);
         
         sf::Text instruction;
         instruction.setFont(font);
@@ -623,7 +618,7 @@ void GameStates::renderQuiz(Game* game) {
         instruction.setLineSpacing(1.2f);
         sf::FloatRect instructionBounds = instruction.getLocalBounds();
         instruction.setPosition(1024.0f / 2.0f - instructionBounds.width / 2.0f, 560.0f);
-        window.draw(instruction);
+        tree.add(instruction);
     } else {
         sf::Text instruction;
         instruction.setFont(font);
@@ -633,19 +628,29 @@ void GameStates::renderQuiz(Game* game) {
         instruction.setLineSpacing(1.2f);
         sf::FloatRect instructionBounds = instruction.getLocalBounds();
         instruction.setPosition(1024.0f / 2.0f - instructionBounds.width / 2.0f, 500.0f);
-        window.draw(instruction);
+        tree.add(instruction);
     }
 }
 
 void GameStates::renderPlanetInfo(Game* game) {
-    sf::RenderWindow& window = game->getWindow();
-    sf::Font& font = game->getFont();
-    
     if (game->getSelectedPlanet().empty()) {
         game->setCurrentState(Game::GameState::SOLAR_SYSTEM);
         return;
     }
     
+    WidgetTree& tree = game->getWidgetTree(Game::GameState::PLANET_INFO);
+    if (tree.isStale(game->getUIRevision())) {
+        tree.clear();
+        GameUI::setupPlanetInfoButtons(game);
+        buildPlanetInfo(game, tree);
+        tree.markBuilt(game->getUIRevision());
+    }
+    GameUI::drawRetained(game, tree);
+}
+
+void GameStates::buildPlanetInfo(Game* game, WidgetTree& tree) {
+    sf::Font& font = game->getFont();
+    
     bool isUnlocked = GameLogic::isPlanetUnlocked(game, game->getSelectedPlanet());
     
     sf::RectangleShape panel(sf::Vector2f(900, 600));
@@ -653,7 +658,7 @@ void GameStates::renderPlanetInfo(Game* game) {
     panel.setFillColor(sf::Color(20, 20, 40, 220));
     panel.setOutlineThickness(3);
     panel.setOutlineColor(isUnlocked ? sf::Color::Yellow : sf::Color::Red);
-    window.draw(panel);
+    tree.add(panel);
     
     sf::Text nameText;
     nameText.setFont(font);
@@ -663,7 +668,7 @@ void GameStates::renderPlanetInfo(Game* game) {
     nameText.setStyle(sf::Text::Bold);
     sf::FloatRect nameBounds = nameText.getLocalBounds();
     nameText.setPosition(1024/2.0f - nameBounds.width/2.0f, 100);
-    window.draw(nameText);
+    tree.add(nameText);
     
     if (game->planetInfo.find(game->getSelectedPlanet()) != game->planetInfo.end()) {
         const auto& info = game->planetInfo[game->getSelectedPlanet()];
@@ -683,7 +688,7 @@ void GameStates::renderPlanetInfo(Game* game) {
         }
         
         descText.setPosition(1024/2.0f - descBounds.width/2.0f, 160);
-        window.draw(descText);
+        tree.add(descText);
         
         float factsY = 220.0f;
         sf::Text factsTitle;
@@ -692,7 +697,7 @@ void GameStates::renderPlanetInfo(Game* game) {
         factsTitle.setCharacterSize(24);
         factsTitle.setFillColor(sf::Color(255, 200, 100));
         factsTitle.setPosition(100, factsY);
-        window.draw(factsTitle);
+        tree.add(factsTitle);
         
         factsY += 40;
         for (const auto& fact : info.facts) {
@@ -702,7 +707,7 @@ void GameStates::renderPlanetInfo(Game* game) {
             factText.setCharacterSize(20);
             factText.setFillColor(sf::Color(200, 220, 255));
             factText.setPosition(120, factsY);
-            window.draw(factText);
+            tree.add(factText);
             factsY += 30;
         }
         
@@ -766,46 +771,12 @@ void GameStates::renderPlanetInfo(Game* game) {
         reqText.setCharacterSize(22);
         reqText.setLineSpacing(1.2f);
         reqText.setPosition(100, factsY);
-        window.draw(reqText);
-    }
-    
-    if (isUnlocked) {
-        game->currentButtons.clear();
-        game->currentButtons.push_back(GameUI::createButton(
-            "Take " + game->getSelectedPlanet() + " Quiz", 
-            362, 
-            490, 
-            300, 
-            50, 
-            Game::GameState::QUIZ
-        ));
-        game->currentButtons.push_back(GameUI::createButton(
-            "Study More", 
-            362, 
-            550, 
-            300, 
-            50, 
-            Game::GameState::SOLAR_SYSTEM
-        ));
-        game->currentButtons.push_back(GameUI::createButton(
-            "Back to Solar System", 
-            362, 
-            610, 
-            300, 
-            50, 
-            Game::GameState::SOLAR_SYSTEM
-        ));
-        
-        for (const auto& button : game->currentButtons) {
-            GameUI::drawButton(button, window, font);
-        }
-    } else {
-        game->currentButtons.clear();
-        game->currentButtons.push_back(GameUI::createButton(
-            "Back to Solar System", 362, 550, 300, 50, Game::GameState::SOLAR_SYSTEM
-        ));
-        GameUI::drawButton(game->currentButtons[0], window, font);
-        
+        tree.add(reqText);
+    }
+    
+    GameUI::addButtons(game, tree);
+    
+    if (!isUnlocked) {
         sf::Text lockText;
         lockText.setFont(font);
         lockText.setString("This celestial body is locked.\nComplete previous bodies to unlock it.");
@@ -814,12 +785,23 @@ void GameStates::renderPlanetInfo(Game* game) {
         lockText.setLineSpacing(1.3f);
         sf::FloatRect lockBounds = lockText.getLocalBounds();
         lockText.setPosition(1024/2.0f - lockBounds.width/2.0f, 450);
-        window.draw(lockText);
+        tree.add(lockText);
     }
 }
 
 void GameStates::renderAchievements(Game* game) {
-    sf::RenderWindow& window = game->getWindow();
+    WidgetTree& tree = game->getWidgetTree(Game::GameState::ACHIEVEMENTS);
+    long long dataKey = game->getPlayer() ? game->getPlayer()->getScore() : -1;
+    if (tree.isStale(game->getUIRevision(), dataKey)) {
+        tree.clear();
+        buildAchievements(game, tree);
+        tree.markBuilt(game->getUIRevision(), dataKey);
+    }
+    GameUI::drawRetained(game, tree);
+    game->getAchievementList().draw(game->getFrame());
+}
+
+void GameStates::buildAchievements(Game* game, WidgetTree& tree) {
     sf::Font& font = game->getFont();
     
     sf::Text title;
@@ -830,67 +812,34 @@ void GameStates::renderAchievements(Game* game) {
     title.setStyle(sf::Text::Bold);
     sf::FloatRect titleBounds = title.getLocalBounds();
     title.setPosition(1024/2.0f - titleBounds.width/2.0f, 50);
-    window.draw(title);
-    
-    if (game->getPlayer()) {
-        auto achievements = game->getPlayer()->getAchievements();
-        
-        if (achievements.empty()) {
-            sf::Text noAch;
-            noAch.setFont(font);
-            noAch.setString("No achievements yet");
-            noAch.setCharacterSize(24);
-            noAch.setFillColor(sf::Color::White);
-            sf::FloatRect noAchBounds = noAch.getLocalBounds();
-            noAch.setPosition(1024/2.0f - noAchBounds.width/2.0f, 200);
-            window.draw(noAch);
-        } else {
-            float startY = 150.0f;
-            
-            for (size_t i = 0; i < achievements.size(); ++i) {
-                const auto& ach = achievements[i];
-                
-                sf::RectangleShape bg(sf::Vector2f(900, 50));
-                bg.setPosition(62, startY + i * 60);
-                bg.setFillColor(sf::Color(30, 30, 60, 200));
-                bg.setOutlineThickness(2);
-                bg.setOutlineColor(ach.unlocked ? sf::Color::Yellow : sf::Color(100, 100, 100));
-                window.draw(bg);
-                
-                std::string displayText = ach.name + " - " + ach.description;
-                sf::Text name;
-                name.setFont(font);
-                name.setString(displayText);
-                name.setCharacterSize(20);
-                name.setFillColor(ach.unlocked ? sf::Color::White : sf::Color(150, 150, 150));
-                
-                sf::FloatRect nameBounds = name.getLocalBounds();
-                if (nameBounds.width > 700) {
-                    float scale = 700.0f / nameBounds.width;
-                    name.setScale(scale, 1.0f);
-                }
-                
-                name.setPosition(100, startY + i * 60 + 15);
-                window.draw(name);
-                
-                sf::Text status;
-                status.setFont(font);
-                status.setString(ach.unlocked ? "UNLOCKED" : "LOCKED");
-                status.setCharacterSize(18);
-                status.setFillColor(ach.unlocked ? sf::Color::Green : sf::Color::Red);
-                status.setPosition(800, startY + i * 60 + 15);
-                window.draw(status);
-            }
-        }
+    tree.add(title);
+    
+    if (game->getPlayer() && game->getAchievementRows().getRowCount() == 0) {
+        sf::Text noAch;
+        noAch.setFont(font);
+        noAch.setString("No achievements yet");
+        noAch.setCharacterSize(24);
+        noAch.setFillColor(sf::Color::White);
+        sf::FloatRect noAchBounds = noAch.getLocalBounds();
+        noAch.setPosition(1024/2.0f - noAchBounds.width/2.0f, 200);
+        tree.add(noAch);
     }
     
-    for (const auto& button : game->currentButtons) {
-        GameUI::drawButton(button, window, font);
-    }
+    GameUI::addButtons(game, tree);
 }
 
 void GameStates::renderStatistics(Game* game) {
-    sf::RenderWindow& window = game->getWindow();
+    WidgetTree& tree = game->getWidgetTree(Game::GameState::STATISTICS);
+    if (tree.isStale(game->getUIRevision())) {
+        tree.clear();
+        buildStatistics(game, tree);
+        tree.markBuilt(game->getUIRevision());
+    }
+    GameUI::drawRetained(game, tree);
+    game->getLeaderboardList().draw(game->getFrame());
+}
+
+void GameStates::buildStatistics(Game* game, WidgetTree& tree) {
     sf::Font& font = game->getFont();
     
     sf::Text title;
@@ -901,40 +850,40 @@ void GameStates::renderStatistics(Game* game) {
     title.setStyle(sf::Text::Bold);
     sf::FloatRect titleBounds = title.getLocalBounds();
     title.setPosition(1024/2.0f - titleBounds.width/2.0f, 50);
-    window.draw(title);
+    tree.add(title);
     
-    try {
-        auto allPlayers = GameDatabase::getAllPlayersFromDB();
-        
-        if (allPlayers.empty()) {
-            sf::Text noData;
-            noData.setFont(font);
-            noData.setString("No player statistics available.\nDatabase is not connected or no players exist.");
-            noData.setCharacterSize(24);
-            noData.setFillColor(sf::Color::White);
-            noData.setLineSpacing(1.5f);
-            sf::FloatRect noDataBounds = noData.getLocalBounds();
-            noData.setPosition(1024/2.0f - noDataBounds.width/2.0f, 200);
-            window.draw(noData);
-        } else {
-            GameUI::renderMultiplePlayersStats(game, window, font);
-        }
-        
-    } catch (const std::exception& e) {
+    const LeaderboardSource& leaderboard = game->getLeaderboard();
+    if (!leaderboard.getError().empty()) {
         sf::Text error;
         error.setFont(font);
-        error.setString("Error loading statistics:\n" + std::string(e.what()));
+        error.setString("Error loading statistics:\n" + leaderboard.getError());
         error.setCharacterSize(24);
         error.setFillColor(sf::Color::Red);
         error.setLineSpacing(1.5f);
         sf::FloatRect errorBounds = error.getLocalBounds();
         error.setPosition(1024/2.0f - errorBounds.width/2.0f, 200);
-        window.draw(error);
+        tree.add(error);
+    } else if (leaderboard.getRowCount() == 0) {
+        sf::Text noData;
+        noData.setFont(font);
+        noData.setString("No player statistics available.\nDatabase is not connected or no players exist.");
+        noData.setCharacterSize(24);
+        noData.setFillColor(sf::Color::White);
+        noData.setLineSpacing(1.5f);
+        sf::FloatRect noDataBounds = noData.getLocalBounds();
+        noData.setPosition(1024/2.0f - noDataBounds.width/2.0f, 200);
+        tree.add(noData);
+    } else {
+        sf::Text columnTitle;
+        columnTitle.setFont(font);
+        columnTitle.setString("Player Statistics: " + std::to_string(leaderboard.getRowCount()) + " players");
+        columnTitle.setCharacterSize(24);
+        columnTitle.setFillColor(sf::Color::Yellow);
+        columnTitle.setPosition(50, 120);
+        tree.add(columnTitle);
     }
     
-    for (const auto& button : game->currentButtons) {
-        GameUI::drawButton(button, window, font);
-    }
+    GameUI::addButtons(game, tree);
     
     sf::Text instruction;
     instruction.setFont(font);
@@ -943,30 +892,42 @@ void GameStates::renderStatistics(Game* game) {
     instruction.setFillColor(sf::Color(200, 200, 200));
     sf::FloatRect instructionBounds = instruction.getLocalBounds();
     instruction.setPosition(1024/2.0f - instructionBounds.width/2.0f, 700);
-    window.draw(instruction);
+    tree.add(instruction);
 }
 
 void GameStates::renderHUD(Game* game) {
-    sf::RenderWindow& window = game->getWindow();
+    WidgetTree& tree = game->getHudTree();
+    
+    int unlockedCount = 0;
+    for (const auto& [name, unlocked] : game->planetUnlockStatus) {
+        if (unlocked) unlockedCount++;
+    }
+    long long dataKey = (game->getPlayer() ? game->getPlayer()->getScore() : 0) * 1000LL + unlockedCount;
+    
+    if (tree.isStale(game->getUIRevision(), dataKey)) {
+        tree.clear();
+        buildHUD(game, tree, unlockedCount);
+        tree.markBuilt(game->getUIRevision(), dataKey);
+    }
+    
+    tree.draw(game->getFrame());
+}
+
+void GameStates::buildHUD(Game* game, WidgetTree& tree, int unlockedCount) {
     sf::Font& font = game->getFont();
     
     sf::RectangleShape panel(sf::Vector2f(1024, 30));
     panel.setFillColor(sf::Color(0, 0, 0, 180));
-    window.draw(panel);
+    tree.add(panel);
     
-    std::string stateName;
-    switch (game->getCurrentState()) {
-        case Game::GameState::LOGIN: stateName = "Login"; break;
-        case Game::GameState::MAIN_MENU: stateName = "Main Menu"; break;
-        case Game::GameState::SOLAR_SYSTEM: stateName = "Solar System"; break;
-        case Game::GameState::QUIZ: stateName = "Quiz"; break;
-        case Game::GameState::PLANET_INFO: stateName = "Planet Info"; break;
-        case Game::GameState::ACHIEVEMENTS: stateName = "Achievements"; break;
-        case Game::GameState::STATISTICS: stateName = "Statistics"; break;
-    }
+    std::string stateName = Game::getStateName(game->getCurrentState());
     
     if (game->isPaused()) {
         stateName += " [PAUSED]";
+    } else if (game->getCurrentState() == Game::GameState::SOLAR_SYSTEM && game->getTimeScale() != 1.0f) {
+        std::ostringstream warp;
+        warp << " [x" << game->getTimeScale() << "]";
+        stateName += warp.str();
     }
     
     sf::Text stateText;
@@ -976,14 +937,9 @@ void GameStates::renderHUD(Game* game) {
     stateText.setCharacterSize(16);
     stateText.setFillColor(sf::Color::White);
     stateText.setPosition(10, 8);
-    window.draw(stateText);
+    tree.add(stateText);
     
     if (game->getCurrentState() != Game::GameState::LOGIN) {
-        int unlockedCount = 0;
-        for (const auto& [name, unlocked] : game->planetUnlockStatus) {
-            if (unlocked) unlockedCount++;
-        }
-        
         sf::Text planetCount;
         planetCount.setFont(font);
         planetCount.setString("Planets: " + std::to_string(unlockedCount) + "/" + 
@@ -992,19 +948,26 @@ void GameStates::renderHUD(Game* game) {
         planetCount.setFillColor(unlockedCount == game->planetUnlockStatus.size() ? 
                                 sf::Color::Green : sf::Color::Yellow);
         planetCount.setPosition(800, 8);
-        window.draw(planetCount);
+        tree.add(planetCount);
     }
     
-    if (game->getDeltaTime() > 0) {
-        std::string fpsText = "FPS: " + std::to_string(static_cast<int>(1.0f / game->getDeltaTime()));
-        
-        sf::Text fpsDisplay;
-        fpsDisplay.setFont(font);
-        fpsDisplay.setString(fpsText);
-        fpsDisplay.setCharacterSize(16);
-        fpsDisplay.setFillColor(sf::Color::White);
-        sf::FloatRect fpsBounds = fpsDisplay.getLocalBounds();
-        fpsDisplay.setPosition(1024 - fpsBounds.width - 10, 8);
-        window.draw(fpsDisplay);
+    sf::Text profilerHint;
+    profilerHint.setFont(font);
+    profilerHint.setString("F3: frame stats");
+    profilerHint.setCharacterSize(16);
+    profilerHint.setFillColor(sf::Color(180, 180, 180));
+    sf::FloatRect hintBounds = profilerHint.getLocalBounds();
+    profilerHint.setPosition(1024 - hintBounds.width - 10, 8);
+    tree.add(profilerHint);
+    
+    if (game->getCapture().isRecording()) {
+        sf::Text recording;
+        recording.setFont(font);
+        recording.setString("REC (F10 to stop)");
+        recording.setCharacterSize(16);
+        recording.setFillColor(sf::Color::Red);
+        sf::FloatRect recordingBounds = recording.getLocalBounds();
+        recording.setPosition(1024 - recordingBounds.width - 10, 28);
+        tree.add(recording);
     }
 }
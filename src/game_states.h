@@ -2,10 +2,22 @@
 #define GAME_STATES_H
 
 #include "game.h"
+#include "widget_tree.h"
+#include "text_layout.h"
 
 class GameStates {
 public:
+    // Parts of a question for TextLayoutCache ids.
+    enum QuestionPart {
+        QUESTION_TEXT = 0,
+        QUESTION_EXPLANATION = 1,
+        QUESTION_OPTION = 2,
+        QUESTION_RETRY_ITEM = 16
+    };
+    
     static void renderLogin(Game* game);
+    // Toggles the cursor in the built login tree without rebuilding it.
+    static void updateLoginCursor(Game* game);
     static void renderMainMenu(Game* game);
     static void renderSolarSystem(Game* game);
     static void renderQuiz(Game* game);
@@ -13,6 +25,16 @@ public:
     static void renderAchievements(Game* game);
     static void renderStatistics(Game* game);
     static void renderHUD(Game* game);
+
+private:
+    static void buildLogin(Game* game, WidgetTree& tree);
+    static std::string loginInputText(Game* game);
+    static void buildMainMenu(Game* game, WidgetTree& tree);
+    static void buildQuizQuestion(Game* game, WidgetTree& tree);
+    static void buildPlanetInfo(Game* game, WidgetTree& tree);
+    static void buildAchievements(Game* game, WidgetTree& tree);
+    static void buildStatistics(Game* game, WidgetTree& tree);
+    static void buildHUD(Game* game, WidgetTree& tree, int unlockedCount);
 };
 
 #endif
@@ -2,20 +2,18 @@
 #define GAME_UI_H
 
 #include "game.h"
+#include "widget_tree.h"
 
 class GameUI {
 public:
-    static void initLoginScreen(Game* game);
-    static void initMainMenu(Game* game);
-    static void initQuizUI(Game* game);
-    static void initPlanetInfoUI(Game* game);
-    static void initStatisticsUI(Game* game);
+    static std::string buttonLabel(Game* game, const UILayout::Button& button);
+    static void buildButton(Game* game, size_t index, sf::RectangleShape& shape, sf::Text& label);
+    static sf::Color buttonFillColor(Game* game, size_t index);
+    static void drawButtons(Game* game);
     
-    static Game::Button createButton(const std::string& text, float x, float y, 
-                                   float width, float height, Game::GameState targetState);
-    static void drawButton(const Game::Button& button, sf::RenderWindow& window, sf::Font& font);
-    
-    static void renderMultiplePlayersStats(Game* game, sf::RenderWindow& window, sf::Font& font);
+    static void addButtons(Game* game, WidgetTree& tree);
+    static void drawRetained(Game* game, WidgetTree& tree);
+    static void setupPlanetInfoButtons(Game* game);
 };
 
 #endif
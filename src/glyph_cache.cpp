@@ -0,0 +1,195 @@
+#include "glyph_cache.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+namespace {
+
+// Quiz sizes first, since those screens carry most of the Cyrillic text.
+const unsigned int DEFAULT_SIZES[] = {24, 20, 22, 28, 36, 18, 16, 14, 13, 48};
+
+}
+
+GlyphCache::GlyphCache(const std::string& manifestPath)
+    : manifestPath(manifestPath)
+    , font(nullptr)
+    , manifestChanged(false)
+    , nextSize(0)
+    , warmStarted(false)
+    , warmedGlyphs(0)
+    , framesNoted(0)
+    , hitchFrames(0) {
+    
+    for (sf::Uint32 c = 32; c < 127; ++c) {
+        codePoints.insert(c);
+    }
+    for (unsigned int size : DEFAULT_SIZES) {
+        addSize(size, false);
+        addSize(size, true);
+    }
+    manifestChanged = false;
+}
+
+void GlyphCache::setFont(sf::Font* font) {
+    this->font = font;
+    pageSizes.clear();
+    if (font) {
+        for (const auto& key : sizes) {
+            snapshotPage(key.characterSize);
+        }
+    }
+}
+
+bool GlyphCache::loadManifest() {
+    std::ifstream file(manifestPath);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    std::string line;
+    std::string section;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        if (line.front() == '[') {
+            section = line;
+            continue;
+        }
+        
+        std::istringstream values(line);
+        if (section == "[Sizes]") {
+            unsigned int characterSize = 0;
+            int bold = 0;
+            if (values >> characterSize >> bold) {
+                addSize(characterSize, bold != 0);
+            }
+        } else if (section == "[CodePoints]") {
+            sf::Uint32 codePoint = 0;
+            while (values >> std::hex >> codePoint) {
+                codePoints.insert(codePoint);
+            }
+        }
+    }
+    
+    manifestChanged = false;
+    std::cout << "Glyph manifest loaded: " << codePoints.size() << " code points, "
+              << sizes.size() << " sizes" << std::endl;
+    return true;
+}
+
+bool GlyphCache::saveManifest() const {
+    if (!manifestChanged) {
+        return true;
+    }
+    
+    std::ofstream file(manifestPath);
+    if (!file.is_open()) {
+        std::cerr << "Cannot write glyph manifest: " << manifestPath << std::endl;
+        return false;
+    }
+    
+    file << "[Sizes]\n";
+    for (const auto& key : sizes) {
+        file << key.characterSize << " " << (key.bold ? 1 : 0) << "\n";
+    }
+    
+    file << "[CodePoints]\n" << std::hex;
+    int column = 0;
+    for (sf::Uint32 codePoint : codePoints) {
+        file << codePoint << (++column % 16 == 0 ? "\n" : " ");
+    }
+    file << "\n";
+    return true;
+}
+
+void GlyphCache::addText(const sf::String& text) {
+    for (sf::Uint32 codePoint : text) {
+        if (codePoint > ' ' && codePoints.insert(codePoint).second) {
+            manifestChanged = true;
+        }
+    }
+}
+
+void GlyphCache::addSize(unsigned int characterSize, bool bold) {
+    SizeKey key{characterSize, bold};
+    if (characterSize > 0 && knownSizes.insert(key).second) {
+        sizes.push_back(key);
+        manifestChanged = true;
+    }
+}
+
+bool GlyphCache::warmStep(sf::Time budget) {
+    if (isWarm()) {
+        return true;
+    }
+    
+    sf::Clock clock;
+    if (!warmStarted) {
+        nextCodePoint = codePoints.begin();
+        warmStarted = true;
+    }
+    
+    while (nextSize < sizes.size() && clock.getElapsedTime() < budget) {
+        const SizeKey& key = sizes[nextSize];
+        font->getGlyph(*nextCodePoint, key.characterSize, key.bold);
+        warmedGlyphs++;
+        
+        if (++nextCodePoint == codePoints.end()) {
+            nextCodePoint = codePoints.begin();
+            nextSize++;
+        }
+    }
+    
+    // Growth caused by warming is not a hitch.
+    for (auto& [characterSize, pageSize] : pageSizes) {
+        pageSize = font->getTexture(characterSize).getSize();
+    }
+    if (nextSize < sizes.size()) {
+        snapshotPage(sizes[nextSize].characterSize);
+    }
+    
+    warmTime += clock.getElapsedTime();
+    if (isWarm()) {
+        std::cout << "Glyphs pre-warmed: " << warmedGlyphs << " in "
+                  << warmTime.asMilliseconds() << " ms" << std::endl;
+    }
+    return isWarm();
+}
+
+void GlyphCache::noteFrame(const DrawList& frame) {
+    if (!font) {
+        return;
+    }
+    
+    for (const auto& used : frame.getTextSizes()) {
+        addSize(used.first, used.second);
+        if (pageSizes.find(used.first) == pageSizes.end()) {
+            // First use of this size: its page was created while recording.
+            pageSizes[used.first] = sf::Vector2u(0, 0);
+        }
+    }
+    
+    bool grew = false;
+    for (auto& [characterSize, pageSize] : pageSizes) {
+        sf::Vector2u current = font->getTexture(characterSize).getSize();
+        if (current != pageSize) {
+            grew = true;
+            pageSize = current;
+        }
+    }
+    
+    framesNoted++;
+    if (grew) {
+        hitchFrames++;
+    }
+}
+
+void GlyphCache::snapshotPage(unsigned int characterSize) {
+    pageSizes[characterSize] = font->getTexture(characterSize).getSize();
+}
+
+void GlyphCache::printReport() const {
+    std::cout << "Glyph cache: " << warmedGlyphs << " glyphs pre-warmed in " << warmTime.asMilliseconds()
+              << " ms; font atlas grew during " << hitchFrames << " of " << framesNoted << " frames" << std::endl;
+}
@@ -0,0 +1,69 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <SFML/Graphics.hpp>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "draw_list.h"
+
+// Pre-rasterises the glyphs the game is going to need so sf::Font does not
+// do it lazily in the middle of a frame. sf::Font cannot adopt an atlas
+// from disk, so what persists between runs is the manifest of code points
+// and character sizes, including sizes first seen at runtime; the next
+// start warms all of them. Warming runs in small time slices so it does
+// not delay the first frames.
+class GlyphCache {
+public:
+    explicit GlyphCache(const std::string& manifestPath = "glyph_cache.dat");
+    
+    void setFont(sf::Font* font);
+    bool loadManifest();
+    bool saveManifest() const;
+    
+    void addText(const sf::String& text);
+    void addSize(unsigned int characterSize, bool bold);
+    
+    // Rasterises glyphs until the budget runs out; returns true once done.
+    bool warmStep(sf::Time budget);
+    bool isWarm() const { return font == nullptr || nextSize >= sizes.size(); }
+    
+    // Records the text sizes a frame used and whether any font page had
+    // to grow while recording it.
+    void noteFrame(const DrawList& frame);
+    
+    void printReport() const;
+
+private:
+    struct SizeKey {
+        unsigned int characterSize;
+        bool bold;
+        
+        bool operator<(const SizeKey& other) const {
+            return characterSize != other.characterSize ? characterSize < other.characterSize : bold < other.bold;
+        }
+    };
+    
+    std::string manifestPath;
+    sf::Font* font;
+    
+    std::set<sf::Uint32> codePoints;
+    std::vector<SizeKey> sizes;
+    std::set<SizeKey> knownSizes;
+    bool manifestChanged;
+    
+    size_t nextSize;
+    std::set<sf::Uint32>::const_iterator nextCodePoint;
+    bool warmStarted;
+    
+    std::map<unsigned int, sf::Vector2u> pageSizes;
+    int warmedGlyphs;
+    sf::Time warmTime;
+    int framesNoted;
+    int hitchFrames;
+    
+    void snapshotPage(unsigned int characterSize);
+};
+
+#endif
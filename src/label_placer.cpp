@@ -0,0 +1,335 @@
+#include "label_placer.h"
+#include <algorithm>
+#include <array>
+
+namespace {
+
+// Truncation instead of std::floor, which is a library call without
+// SSE4.1; the bias keeps coordinates positive for anything near the
+// screen, so truncation rounds the same way on both sides of the origin.
+const float CELL_SCALE = 1.0f / LabelPlacer::CELL_SIZE;
+const int CELL_BIAS = 1 << 20;
+const int WORD_SHIFT = 6;
+const int WORD_MASK = 63;
+const uint32_t NO_BLOCKER = 0xffffffff;
+
+int cellOf(float coordinate) {
+    return static_cast<int>(coordinate * CELL_SCALE + CELL_BIAS);
+}
+
+// Bits first..last; for last == 63 the shift gives zero, and zero
+// minus one is all bits.
+uint64_t columnMask(int first, int last) {
+    return ((uint64_t(2) << last) - 1) & ~((uint64_t(1) << first) - 1);
+}
+
+// Index of a single set bit, by de Bruijn multiplication; a loop here
+// mispredicts on every hit.
+int bitIndex(uint64_t bit) {
+    static const uint8_t INDEX[64] = {
+        0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+    };
+    return INDEX[(bit * 0x03f79d71b4cb0a89ull) >> 58];
+}
+
+int lowestBit(uint64_t bits) {
+    return bitIndex(bits & (~bits + 1));
+}
+
+int highestBit(uint64_t bits) {
+    bits |= bits >> 1;
+    bits |= bits >> 2;
+    bits |= bits >> 4;
+    bits |= bits >> 8;
+    bits |= bits >> 16;
+    bits |= bits >> 32;
+    return bitIndex(bits - (bits >> 1));
+}
+
+}
+
+const std::vector<uint8_t>& LabelPlacer::place(const std::vector<Candidate>& candidates, const sf::FloatRect& bounds) {
+    result.assign(candidates.size(), HIDDEN);
+    
+    int left = cellOf(bounds.left);
+    int top = cellOf(bounds.top);
+    int columns = std::max(1, cellOf(bounds.left + bounds.width) - left + 1);
+    int rows = std::max(1, cellOf(bounds.top + bounds.height) - top + 1);
+    // Remembered blockers are grid cells, and may lie outside a new grid.
+    if (left != gridLeft || top != gridTop || columns != gridColumns || rows != gridRows) {
+        std::fill(blockers.begin(), blockers.end(), NO_BLOCKER);
+    }
+    gridLeft = left;
+    gridTop = top;
+    gridColumns = columns;
+    gridRows = rows;
+    gridWords = (gridColumns + WORD_MASK) >> WORD_SHIFT;
+    grid.assign(static_cast<size_t>(gridWords) * gridRows, 0);
+    
+    // Highest priority first; among equals, labels that were shown last
+    // frame, then by index.
+    ranks.resize(candidates.size());
+    firsts.resize(candidates.size());
+    uint32_t maxKey = 0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const Candidate& candidate = candidates[i];
+        uint8_t last = candidate.key < previous.size() ? previous[candidate.key] : static_cast<uint8_t>(HIDDEN);
+        bool wasShown = last != HIDDEN;
+        uint32_t rank = (static_cast<uint32_t>(candidate.priority) << 1) | (wasShown ? 1u : 0u);
+        ranks[i] = ~rank & 0x1ffff;
+        firsts[i] = wasShown ? last : static_cast<uint8_t>(ABOVE);
+        maxKey = std::max(maxKey, candidate.key);
+    }
+    if (!candidates.empty()) {
+        if ((static_cast<size_t>(maxKey) + 1) * ANCHOR_COUNT > blockers.size()) {
+            blockers.resize((static_cast<size_t>(maxKey) + 1) * ANCHOR_COUNT, NO_BLOCKER);
+        }
+        if (maxKey >= previous.size()) {
+            previous.resize(maxKey + 1);
+        }
+    }
+    std::fill(previous.begin(), previous.end(), static_cast<uint8_t>(HIDDEN));
+    
+    // A comparison sort alone would take most of the budget at 5000
+    // labels, so a changed set of candidates gets a stable radix sort on
+    // the inverted 17-bit rank.
+    if (order.size() != candidates.size() || !resort()) {
+        order.resize(candidates.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = static_cast<uint32_t>(i);
+        }
+        for (int shift = 0; shift < 17; shift += RADIX_BITS) {
+            radixPass(shift);
+        }
+    }
+    
+    // Copied into that order, so the loop below reads them in sequence.
+    sorted.resize(order.size());
+    for (size_t k = 0; k < order.size(); ++k) {
+        sorted[k] = candidates[order[k]];
+    }
+    
+    for (size_t k = 0; k < order.size(); ++k) {
+        uint32_t i = order[k];
+        const Candidate& candidate = sorted[k];
+        Cells anchors[ANCHOR_COUNT];
+        anchorCells(candidate, anchors);
+        bool inside = anchors[LEFT].left >= 0 && anchors[RIGHT].right < gridColumns &&
+                      anchors[ABOVE].top >= 0 && anchors[BELOW].bottom < gridRows;
+        
+        bool wasShown = (ranks[i] & 1) == 0;
+        uint8_t first = firsts[i];
+        uint32_t* blocked = &blockers[static_cast<size_t>(candidate.key) * ANCHOR_COUNT];
+        // The first anchor of a shown label is tested shrunk, below.
+        uint32_t stale = blockedAnchors(anchors, blocked);
+        if (wasShown) {
+            stale &= ~(1u << first);
+        }
+        if (stale == (1u << ANCHOR_COUNT) - 1) {
+            continue;
+        }
+        
+        for (uint8_t attempt = 0; attempt < ANCHOR_COUNT; ++attempt) {
+            Anchor anchor = static_cast<Anchor>(attempt == 0 ? first : (attempt <= first ? attempt - 1 : attempt));
+            if (stale & (1u << anchor)) {
+                continue;
+            }
+            Cells cells = anchors[anchor];
+            
+            // A label keeps its place until it overlaps by more than a
+            // cell, so rounding to cells does not make it flicker.
+            Cells tested = cells;
+            if (wasShown && attempt == 0 && cells.right - cells.left >= 2 && cells.bottom - cells.top >= 2) {
+                tested = {cells.left + 1, cells.top + 1, cells.right - 1, cells.bottom - 1};
+            }
+            
+            // Outside the bounds nothing is seen, so nothing can overlap.
+            if (!inside) {
+                if (!clip(cells)) {
+                    result[i] = anchor;
+                    break;
+                }
+                if (!clip(tested)) {
+                    insert(cells);
+                    result[i] = anchor;
+                    break;
+                }
+            }
+            if (wasShown && attempt == 0 && stillBlocks(tested, blocked[anchor])) {
+                continue;
+            }
+            if (!collides(tested, blocked[anchor])) {
+                insert(cells);
+                result[i] = anchor;
+                break;
+            }
+        }
+        previous[candidate.key] = result[i];
+    }
+    return result;
+}
+
+bool LabelPlacer::resort() {
+    // Last frame's order is nearly sorted for the same candidates, so an
+    // insertion sort finishes in a pass or two; if ranks moved a lot it
+    // gives up and the caller falls back to the radix sort. The index
+    // breaks ties, as in the stable radix sort.
+    sortKeys.resize(order.size());
+    for (size_t k = 0; k < order.size(); ++k) {
+        sortKeys[k] = (static_cast<uint64_t>(ranks[order[k]]) << 32) | order[k];
+    }
+    
+    size_t budget = order.size() * 2;
+    for (size_t k = 1; k < sortKeys.size(); ++k) {
+        uint64_t key = sortKeys[k];
+        size_t j = k;
+        while (j > 0 && sortKeys[j - 1] > key) {
+            sortKeys[j] = sortKeys[j - 1];
+            j--;
+            if (--budget == 0) {
+                return false;
+            }
+        }
+        sortKeys[j] = key;
+    }
+    
+    for (size_t k = 0; k < order.size(); ++k) {
+        order[k] = static_cast<uint32_t>(sortKeys[k]);
+    }
+    return true;
+}
+
+void LabelPlacer::radixPass(int shift) {
+    const uint32_t mask = (1u << RADIX_BITS) - 1;
+    std::array<uint32_t, (1u << RADIX_BITS) + 1> counts{};
+    for (uint32_t i : order) {
+        counts[((ranks[i] >> shift) & mask) + 1]++;
+    }
+    for (size_t d = 1; d < counts.size(); ++d) {
+        counts[d] += counts[d - 1];
+    }
+    
+    scratch.resize(order.size());
+    for (uint32_t i : order) {
+        scratch[counts[(ranks[i] >> shift) & mask]++] = i;
+    }
+    order.swap(scratch);
+}
+
+void LabelPlacer::reset() {
+    previous.clear();
+}
+
+sf::Vector2f LabelPlacer::labelCenter(const Candidate& candidate, Anchor anchor) {
+    const sf::Vector2f& p = candidate.position;
+    float reach = candidate.radius + GAP;
+    switch (anchor) {
+        case BELOW: return sf::Vector2f(p.x, p.y + reach + candidate.size.y / 2);
+        case RIGHT: return sf::Vector2f(p.x + reach + candidate.size.x / 2, p.y);
+        case LEFT: return sf::Vector2f(p.x - reach - candidate.size.x / 2, p.y);
+        default: return sf::Vector2f(p.x, p.y - reach - candidate.size.y / 2);
+    }
+}
+
+void LabelPlacer::anchorCells(const Candidate& candidate, Cells* anchors) const {
+    // The same rectangles as labelCenter() gives, with the edges shared
+    // between anchors converted once.
+    const sf::Vector2f& p = candidate.position;
+    float reach = candidate.radius + GAP;
+    float halfWidth = candidate.size.x * 0.5f;
+    float halfHeight = candidate.size.y * 0.5f;
+    int middleLeft = cellOf(p.x - halfWidth) - gridLeft;
+    int middleRight = cellOf(p.x + halfWidth) - gridLeft;
+    int middleTop = cellOf(p.y - halfHeight) - gridTop;
+    int middleBottom = cellOf(p.y + halfHeight) - gridTop;
+    
+    anchors[ABOVE] = {middleLeft, cellOf(p.y - reach - candidate.size.y) - gridTop,
+                      middleRight, cellOf(p.y - reach) - gridTop};
+    anchors[BELOW] = {middleLeft, cellOf(p.y + reach) - gridTop,
+                      middleRight, cellOf(p.y + reach + candidate.size.y) - gridTop};
+    anchors[RIGHT] = {cellOf(p.x + reach) - gridLeft, middleTop,
+                      cellOf(p.x + reach + candidate.size.x) - gridLeft, middleBottom};
+    anchors[LEFT] = {cellOf(p.x - reach - candidate.size.x) - gridLeft, middleTop,
+                     cellOf(p.x - reach) - gridLeft, middleBottom};
+}
+
+bool LabelPlacer::clip(Cells& cells) const {
+    cells.left = std::max(cells.left, 0);
+    cells.top = std::max(cells.top, 0);
+    cells.right = std::min(cells.right, gridColumns - 1);
+    cells.bottom = std::min(cells.bottom, gridRows - 1);
+    return cells.left <= cells.right && cells.top <= cells.bottom;
+}
+
+uint32_t LabelPlacer::blockedAnchors(const Cells* anchors, const uint32_t* blocked) const {
+    // One bit per anchor whose remembered blocker is still in place.
+    // Written without branches: most candidates come through here, and
+    // whether a blocker moved is not predictable.
+    uint32_t bits = 0;
+    for (int anchor = 0; anchor < ANCHOR_COUNT; ++anchor) {
+        const Cells& cells = anchors[anchor];
+        uint32_t row = blocked[anchor] >> 16;
+        uint32_t column = blocked[anchor] & 0xffff;
+        uint32_t within = (row - cells.top <= static_cast<uint32_t>(cells.bottom - cells.top)) &
+                          (column - cells.left <= static_cast<uint32_t>(cells.right - cells.left));
+        size_t word = within ? static_cast<size_t>(row) * gridWords + (column >> WORD_SHIFT) : 0;
+        bits |= (within & static_cast<uint32_t>(grid[word] >> (column & WORD_MASK))) << anchor;
+    }
+    return bits;
+}
+
+bool LabelPlacer::stillBlocks(const Cells& cells, uint32_t blocker) const {
+    int row = static_cast<int>(blocker >> 16);
+    int column = static_cast<int>(blocker & 0xffff);
+    if (row < cells.top || row > cells.bottom || column < cells.left || column > cells.right) {
+        return false;
+    }
+    return (grid[static_cast<size_t>(row) * gridWords + (column >> WORD_SHIFT)] >> (column & WORD_MASK)) & 1;
+}
+
+bool LabelPlacer::collides(const Cells& cells, uint32_t& blocker) const {
+    int firstWord = cells.left >> WORD_SHIFT;
+    int lastWord = cells.right >> WORD_SHIFT;
+    uint64_t firstMask = columnMask(cells.left & WORD_MASK, firstWord == lastWord ? cells.right & WORD_MASK : 63);
+    uint64_t lastMask = columnMask(0, cells.right & WORD_MASK);
+    
+    for (int row = cells.top; row <= cells.bottom; ++row) {
+        const uint64_t* line = &grid[static_cast<size_t>(row) * gridWords];
+        for (int word = firstWord; word <= lastWord; ++word) {
+            uint64_t mask = word == firstWord ? firstMask : (word == lastWord ? lastMask : ~uint64_t(0));
+            uint64_t hits = line[word] & mask;
+            if (!hits) {
+                continue;
+            }
+            
+            // Labels drift a cell at a time, so the edge of the overlap
+            // is the first cell to clear; remember one further in.
+            int low = lowestBit(hits);
+            int middle = (low + highestBit(hits)) >> 1;
+            int bit = (hits >> middle) & 1 ? middle : low;
+            int hitRow = row;
+            if (row < cells.bottom && ((line[word + gridWords] >> bit) & 1)) {
+                hitRow++;
+            }
+            blocker = (static_cast<uint32_t>(hitRow) << 16) | static_cast<uint32_t>((word << WORD_SHIFT) + bit);
+            return true;
+        }
+    }
+    return false;
+}
+
+void LabelPlacer::insert(const Cells& cells) {
+    int firstWord = cells.left >> WORD_SHIFT;
+    int lastWord = cells.right >> WORD_SHIFT;
+    
+    for (int row = cells.top; row <= cells.bottom; ++row) {
+        uint64_t* line = &grid[static_cast<size_t>(row) * gridWords];
+        for (int word = firstWord; word <= lastWord; ++word) {
+            line[word] |= columnMask(word == firstWord ? cells.left & WORD_MASK : 0,
+                                     word == lastWord ? cells.right & WORD_MASK : 63);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef LABEL_PLACER_H
+#define LABEL_PLACER_H
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Places labels next to the things they name without overlapping each
+// other. Candidates are taken in priority order; each tries the anchor it
+// had last frame and then the others, and is dropped if every anchor
+// collides with a label already placed. Labels shown last frame win ties
+// with new ones, so placement does not flicker.
+//
+// Placed labels are rasterised into an occupancy bitmap over the bounds
+// passed to place(), one bit per CELL_SIZE cell and 64 cells to a word, so
+// testing a rectangle is a mask operation per row and word. Label edges
+// round outwards to whole cells, which leaves at most a cell of space
+// between neighbours. Labels, or parts of them, outside the bounds are not
+// checked.
+//
+// Most candidates at this density are hidden, and stay hidden from frame to
+// frame. For each anchor the placer remembers a cell that blocked it; if
+// that cell is inside the anchor's rectangle and occupied again, the
+// anchor is rejected without scanning, and a candidate whose four anchors
+// are all still blocked is skipped outright. The priority order of the
+// last frame is kept too, and only re-sorted where ranks changed.
+class LabelPlacer {
+public:
+    enum Anchor : uint8_t {
+        ABOVE,
+        BELOW,
+        RIGHT,
+        LEFT,
+        ANCHOR_COUNT,
+        HIDDEN = 0xff
+    };
+    
+    struct Candidate {
+        sf::Vector2f position;
+        float radius;
+        sf::Vector2f size;
+        uint16_t priority;
+        // Dense index that identifies the labelled object across frames.
+        uint32_t key;
+    };
+    
+    // The anchor chosen for each candidate, or HIDDEN.
+    const std::vector<uint8_t>& place(const std::vector<Candidate>& candidates, const sf::FloatRect& bounds);
+    void reset();
+    
+    static sf::Vector2f labelCenter(const Candidate& candidate, Anchor anchor);
+    
+    static constexpr float GAP = 6.0f;
+    static constexpr float CELL_SIZE = 4.0f;
+
+private:
+    // Cell range of a label in the bitmap, inclusive.
+    struct Cells {
+        int left, top, right, bottom;
+    };
+    
+    std::vector<uint8_t> result;
+    std::vector<uint8_t> previous;
+    std::vector<uint32_t> ranks;
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> scratch;
+    std::vector<Candidate> sorted;
+    std::vector<uint64_t> sortKeys;
+    std::vector<uint8_t> firsts;
+    // Packed (row << 16) | column of the cell that last blocked each
+    // anchor, ANCHOR_COUNT per key.
+    std::vector<uint32_t> blockers;
+    
+    std::vector<uint64_t> grid;
+    int gridLeft = 0;
+    int gridTop = 0;
+    int gridColumns = 0;
+    int gridRows = 0;
+    int gridWords = 0;
+    
+    static constexpr int RADIX_BITS = 9;
+    
+    void radixPass(int shift);
+    bool resort();
+    void anchorCells(const Candidate& candidate, Cells* anchors) const;
+    bool clip(Cells& cells) const;
+    
+    uint32_t blockedAnchors(const Cells* anchors, const uint32_t* blocked) const;
+    bool stillBlocks(const Cells& cells, uint32_t blocker) const;
+    bool collides(const Cells& cells, uint32_t& blocker) const;
+    void insert(const Cells& cells);
+};
+
+#endif
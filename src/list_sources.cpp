@@ -0,0 +1,116 @@
+#include "list_sources.h"
+#include "game_database.h"
+#include <iostream>
+#include <ctime>
+
+void LeaderboardSource::reload(const std::string& currentPlayer) {
+    this->currentPlayer = currentPlayer;
+    error.clear();
+    if (fixedRoster) {
+        return;
+    }
+    
+    try {
+        players = GameDatabase::getAllPlayersFromDB();
+    } catch (const std::exception& e) {
+        players.clear();
+        error = e.what();
+        std::cerr << "Error loading player statistics: " << e.what() << std::endl;
+    }
+}
+
+void LeaderboardSource::setFixedRoster(std::vector<Database::PlayerData> roster) {
+    players = std::move(roster);
+    fixedRoster = true;
+}
+
+void LeaderboardSource::buildRow(size_t index, ListRow& row, const sf::Vector2f& cellSize) {
+    const auto& playerData = players[index];
+    bool isCurrent = !currentPlayer.empty() && playerData.name == currentPlayer;
+    
+    sf::RectangleShape playerBg(sf::Vector2f(cellSize.x - 10, cellSize.y - 10));
+    playerBg.setFillColor(sf::Color(30, 30, 60, 200));
+    playerBg.setOutlineThickness(isCurrent ? 3 : 2);
+    playerBg.setOutlineColor(isCurrent ? sf::Color::Yellow : sf::Color(100, 100, 150));
+    row.add(playerBg);
+    
+    if (!font) {
+        return;
+    }
+    
+    sf::Text playerName;
+    playerName.setFont(*font);
+    playerName.setString(playerData.name);
+    playerName.setCharacterSize(20);
+    playerName.setFillColor(isCurrent ? sf::Color::Yellow : sf::Color::White);
+    playerName.setPosition(10, 5);
+    row.add(playerName);
+    
+    sf::Text playerStats;
+    playerStats.setFont(*font);
+    playerStats.setString("Score: " + std::to_string(playerData.totalScore) +
+                         "\nQuizzes: " + std::to_string(playerData.quizzesCompleted));
+    playerStats.setCharacterSize(16);
+    playerStats.setFillColor(sf::Color(200, 200, 255));
+    playerStats.setLineSpacing(1.1f);
+    playerStats.setPosition(10, 30);
+    row.add(playerStats);
+    
+    if (playerData.lastPlayed > 0) {
+        std::time_t now = std::time(nullptr);
+        double daysSince = std::difftime(now, playerData.lastPlayed) / (60 * 60 * 24);
+        
+        sf::Text lastPlayed;
+        lastPlayed.setFont(*font);
+        lastPlayed.setString("Last: " + std::to_string(static_cast<int>(daysSince)) + " days ago");
+        lastPlayed.setCharacterSize(14);
+        lastPlayed.setFillColor(sf::Color(150, 150, 150));
+        lastPlayed.setPosition(cellSize.x - 140, 5);
+        row.add(lastPlayed);
+    }
+}
+
+void AchievementSource::reload(const Player* player) {
+    if (player) {
+        achievements = player->getAchievements();
+    } else {
+        achievements.clear();
+    }
+}
+
+void AchievementSource::buildRow(size_t index, ListRow& row, const sf::Vector2f& cellSize) {
+    const auto& ach = achievements[index];
+    
+    sf::RectangleShape bg(sf::Vector2f(cellSize.x, cellSize.y - 10));
+    bg.setFillColor(sf::Color(30, 30, 60, 200));
+    bg.setOutlineThickness(2);
+    bg.setOutlineColor(ach.unlocked ? sf::Color::Yellow : sf::Color(100, 100, 100));
+    row.add(bg);
+    
+    if (!font) {
+        return;
+    }
+    
+    sf::Text name;
+    name.setFont(*font);
+    name.setString(ach.name + " - " + ach.description);
+    name.setCharacterSize(20);
+    name.setFillColor(ach.unlocked ? sf::Color::White : sf::Color(150, 150, 150));
+    
+    sf::FloatRect nameBounds = name.getLocalBounds();
+    if (nameBounds.width > 700) {
+        float scale = 700.0f / nameBounds.width;
+        name.setScale(scale, 1.0f);
+    }
+    
+    name.setPosition(38, 15);
+    row.add(name);
+    
+    sf::Text status;
+    status.setFont(*font);
+    status.setString(ach.unlocked ? "UNLOCKED" : "LOCKED");
+    status.setCharacterSize(18);
+    status.setFillColor(ach.unlocked ? sf::Color::Green : sf::Color::Red);
+    status.setPosition(cellSize.x - 162, 15);
+    row.add(status);
+}
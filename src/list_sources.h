@@ -0,0 +1,50 @@
+#ifndef LIST_SOURCES_H
+#define LIST_SOURCES_H
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include "virtual_list.h"
+#include "database.h"
+#include "player.h"
+
+// Player cards for the statistics screen. The roster is fetched once per
+// visit to the screen rather than on every rebuild of its widgets.
+class LeaderboardSource : public ListDataSource {
+public:
+    void setFont(const sf::Font* font) { this->font = font; }
+    
+    void reload(const std::string& currentPlayer);
+    const std::string& getError() const { return error; }
+    
+    // Shows this roster instead of asking the database, e.g. in the
+    // render benchmark.
+    void setFixedRoster(std::vector<Database::PlayerData> roster);
+    
+    size_t getRowCount() const override { return players.size(); }
+    void buildRow(size_t index, ListRow& row, const sf::Vector2f& cellSize) override;
+
+private:
+    const sf::Font* font = nullptr;
+    std::vector<Database::PlayerData> players;
+    bool fixedRoster = false;
+    std::string currentPlayer;
+    std::string error;
+};
+
+// The player's achievements, unlocked first, sorted once per visit.
+class AchievementSource : public ListDataSource {
+public:
+    void setFont(const sf::Font* font) { this->font = font; }
+    
+    void reload(const Player* player);
+    
+    size_t getRowCount() const override { return achievements.size(); }
+    void buildRow(size_t index, ListRow& row, const sf::Vector2f& cellSize) override;
+
+private:
+    const sf::Font* font = nullptr;
+    std::vector<Player::Achievement> achievements;
+};
+
+#endif
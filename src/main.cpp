@@ -1,11 +1,109 @@
 #include "game.h"
+#include "score_repair.h"
 #include <iostream>
+#include <string>
+#include <ctime>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include <algorithm>
+#include <thread>
 
-int main() {
+namespace {
+
+// Whole decimal number from min to max; anything else, including trailing
+// characters, is rejected.
+bool parseNumber(const char* value, long min, long max, long& number) {
+    char* end = nullptr;
+    errno = 0;
+    number = std::strtol(value, &end, 10);
+    return end != value && *end == '\0' && errno != ERANGE && number >= min && number <= max;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && std::string(argv[1]) == "--archive-quiz-results") {
+        const char* usage = "Usage: astrolearn --archive-quiz-results DAYS [DIRECTORY] (DAYS from 1 to 36500)";
+        long days = 0;
+        if (argc < 3 || argc > 4) {
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+        if (!parseNumber(argv[2], 1, 36500, days)) {
+            std::cerr << "Invalid number of days: " << argv[2] << std::endl;
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+        std::string archiveDir = argc >= 4 ? argv[3] : "archive";
+        
+        Database& db = Database::getInstance();
+        if (!db.connect()) {
+            std::cerr << "Cannot archive quiz results without a database connection" << std::endl;
+            return 1;
+        }
+        
+        std::time_t cutoff = std::time(nullptr) - static_cast<std::time_t>(days) * 24 * 60 * 60;
+        return db.archiveQuizResults(cutoff, archiveDir) >= 0 ? 0 : 1;
+    }
+    
+    if (argc >= 2 && std::string(argv[1]) == "--repair-scores") {
+        // Workers mostly wait on the database, so a few per core still help.
+        long maxThreads = static_cast<long>(std::max(1u, std::thread::hardware_concurrency())) * 4;
+        std::string usage = "Usage: astrolearn --repair-scores [--apply] [THREADS] (THREADS from 1 to " +
+                            std::to_string(maxThreads) + ")";
+        
+        ScoreRepair::Options options;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            long threads = 0;
+            if (arg == "--apply") {
+                options.apply = true;
+            } else if (parseNumber(argv[i], 1, maxThreads, threads)) {
+                options.threads = static_cast<int>(threads);
+            } else {
+                if (parseNumber(argv[i], LONG_MIN, LONG_MAX, threads)) {
+                    std::cerr << "Invalid thread count: " << arg << std::endl;
+                } else {
+                    std::cerr << "Unknown argument: " << arg << std::endl;
+                }
+                std::cerr << usage << std::endl;
+                return 1;
+            }
+        }
+        
+        ScoreRepair::Report report = ScoreRepair::run(options);
+        return report.failedRanges == 0 ? 0 : 1;
+    }
+    
     std::cout << "AstroLearn Gamified - Starting..." << std::endl;
     
     Game game;
     
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--no-glyph-prewarm") {
+            game.setGlyphPrewarm(false);
+        } else if (arg == "--dynamic-resolution") {
+            game.setResolutionMode(Game::ResolutionMode::DYNAMIC);
+        } else if (arg == "--native-resolution") {
+            game.setResolutionMode(Game::ResolutionMode::NATIVE);
+        } else if (arg == "--vsync") {
+            game.setFramePacing(FramePacer::Mode::VSYNC, 60);
+        } else if (arg == "--uncapped") {
+            game.setFramePacing(FramePacer::Mode::UNCAPPED, 60);
+        } else if (arg.rfind("--fps-cap=", 0) == 0) {
+            const char* value = arg.c_str() + 10;
+            long fps = 0;
+            if (!parseNumber(value, 1, 1000, fps)) {
+                std::cerr << "Invalid frame rate cap: " << value << std::endl;
+                std::cerr << "Usage: astrolearn [--vsync | --uncapped | --fps-cap=N] (N from 1 to 1000)" << std::endl;
+                return 1;
+            }
+            game.setFramePacing(FramePacer::Mode::CAP, static_cast<int>(fps));
+        }
+    }
+    
     if (!game.init()) {
         std::cerr << "Failed to initialize game!" << std::endl;
         return 1;
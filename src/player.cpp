@@ -4,10 +4,56 @@
 #include <sstream>
 #include <algorithm>
 #include <ctime>
+#include <cerrno>
+#include <cstdlib>
+
+namespace {
+
+bool parseNumber(const std::string& field, long long& value) {
+    if (field.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoll(field.c_str(), &end, 10);
+    return errno == 0 && *end == '\0';
+}
+
+// score,correct,total,completedAt,timeSpent,category
+bool parsePendingResult(const std::string& value, Database::QuizResultData& result) {
+    std::istringstream fields(value);
+    long long numbers[5];
+    std::string field;
+    
+    for (long long& number : numbers) {
+        if (!std::getline(fields, field, ',') || !parseNumber(field, number)) {
+            return false;
+        }
+    }
+    for (int i : {0, 1, 2, 4}) {
+        if (numbers[i] < 0 || numbers[i] > 1000000000) {
+            return false;
+        }
+    }
+    if (numbers[1] > numbers[2] || numbers[3] < 0) {
+        return false;
+    }
+    
+    std::getline(fields, result.category);
+    result.score = static_cast<int>(numbers[0]);
+    result.correctAnswers = static_cast<int>(numbers[1]);
+    result.totalQuestions = static_cast<int>(numbers[2]);
+    result.completedAt = static_cast<std::time_t>(numbers[3]);
+    result.timeSpent = static_cast<int>(numbers[4]);
+    return true;
+}
+
+}
 
 Player::Player(const std::string& name)
     : name(name)
-    , totalScore(0) {
+    , totalScore(0)
+    , authenticated(false) {
     
     initializeAchievements();
 }
@@ -20,17 +66,7 @@ bool Player::initialize() {
     }
     
     try {
-        auto playerData = db.getPlayerByName(name);
-        fromDatabaseStruct(playerData);
-        
-        auto dbAchievements = db.getPlayerAchievements(name);
-        for (const auto& dbAch : dbAchievements) {
-            auto it = achievements.find(dbAch.achievementId);
-            if (it != achievements.end()) {
-                it->second.unlocked = true;
-                it->second.unlockDate = static_cast<int>(dbAch.unlockDate);
-            }
-        }
+        applyProfile(db.getPlayerProfile(name));
         
         std::cout << "Loaded existing player from database: " << name 
                   << " (Score: " << totalScore << ")" << std::endl;
@@ -58,17 +94,22 @@ void Player::completeQuiz(const Quiz::QuizResult& result) {
     
     addScore(result.score);
     
+    Database::QuizResultData dbResult;
+    dbResult.playerName = name;
+    dbResult.score = result.score;
+    dbResult.correctAnswers = result.correctAnswers;
+    dbResult.totalQuestions = result.totalQuestions;
+    dbResult.category = result.category;
+    dbResult.completedAt = std::time(nullptr);
+    dbResult.timeSpent = result.timeSpent;
+    
     Database& db = Database::getInstance();
-    if (db.isConnected()) {
-        Database::QuizResultData dbResult;
-        dbResult.playerName = name;
-        dbResult.score = result.score;
-        dbResult.correctAnswers = result.correctAnswers;
-        dbResult.totalQuestions = result.totalQuestions;
-        dbResult.category = result.category;
-        
-        db.saveQuizResult(dbResult);
+    if (db.isConnected() && db.saveQuizResult(dbResult)) {
         saveToDatabase();
+    } else if (authenticated) {
+        pendingResults.push_back(dbResult);
+    } else {
+        unverifiedResults.push_back(dbResult);
     }
     
     checkAchievements();
@@ -121,17 +162,7 @@ bool Player::loadFromDatabase() {
     }
     
     try {
-        Database::PlayerData data = db.getPlayerByName(name);
-        fromDatabaseStruct(data);
-        
-        auto dbAchievements = db.getPlayerAchievements(name);
-        for (const auto& dbAch : dbAchievements) {
-            auto it = achievements.find(dbAch.achievementId);
-            if (it != achievements.end()) {
-                it->second.unlocked = true;
-                it->second.unlockDate = static_cast<int>(dbAch.unlockDate);
-            }
-        }
+        applyProfile(db.getPlayerProfile(name));
         
         std::cout << "Loaded player from database: " << name 
                   << " (Score: " << totalScore << ")" << std::endl;
@@ -158,6 +189,41 @@ bool Player::syncWithDatabase() {
     return true;
 }
 
+int Player::flushPendingResults(bool newAccount) {
+    Database& db = Database::getInstance();
+    if (!authenticated || !db.isConnected()) {
+        return 0;
+    }
+    
+    if (newAccount) {
+        pendingResults.insert(pendingResults.end(), unverifiedResults.begin(), unverifiedResults.end());
+    } else if (!unverifiedResults.empty()) {
+        for (const auto& result : unverifiedResults) {
+            totalScore = std::max(0, totalScore - result.score);
+        }
+        std::cout << "Dropped " << unverifiedResults.size() << " quiz results played offline without logging in as "
+                  << name << std::endl;
+    }
+    unverifiedResults.clear();
+    
+    int flushed = 0;
+    auto it = pendingResults.begin();
+    while (it != pendingResults.end()) {
+        it->playerName = name;
+        if (!db.saveQuizResult(*it)) {
+            break;
+        }
+        it = pendingResults.erase(it);
+        flushed++;
+    }
+    
+    if (flushed > 0) {
+        saveToDatabase();
+    }
+    
+    return flushed;
+}
+
 Database::PlayerData Player::toDatabaseStruct() const {
     Database::PlayerData data;
     
@@ -173,55 +239,68 @@ void Player::fromDatabaseStruct(const Database::PlayerData& data) {
     totalScore = data.totalScore;
 }
 
-void Player::initializeAchievements() {
-    achievements["first_study"] = {
-        "first_study",
-        "First Step",
-        "Study your first celestial body",
-        false, 0, 100
-    };
-    
-    achievements["planet_explorer"] = {
-        "planet_explorer",
-        "Planet Explorer",
-        "Study all planets of the Solar System",
-        false, 0, 500
-    };
-    
-    achievements["star_gazer"] = {
-        "star_gazer",
-        "Star Gazer",
-        "Study 5 different stars",
-        false, 0, 300
-    };
-    
-    achievements["quiz_beginner"] = {
-        "quiz_beginner",
-        "Beginner Astronomer",
-        "Complete your first quiz",
-        false, 0, 200
-    };
-    
-    achievements["quiz_master"] = {
-        "quiz_master",
-        "Quiz Master",
-        "Complete 10 quizzes",
-        false, 0, 1000
-    };
-    
-    achievements["perfect_score"] = {
-        "perfect_score",
-        "Perfection",
-        "Get 100% in a difficult quiz",
-        false, 0, 1500
-    };
-    
-    achievements["space_explorer"] = {
-        "space_explorer",
-        "Space Explorer",
-        "Study 20 different celestial bodies",
-        false, 0, 800
+void Player::applyProfile(const Database::PlayerProfile& profile) {
+    fromDatabaseStruct(profile.player);
+    
+    for (const auto& dbAch : profile.achievements) {
+        auto it = achievements.find(dbAch.achievementId);
+        if (it != achievements.end()) {
+            it->second.unlocked = true;
+            it->second.unlockDate = static_cast<int>(dbAch.unlockDate);
+        }
+    }
+}
+
+const std::map<std::string, Player::Achievement>& Player::achievementDefinitions() {
+    static const std::map<std::string, Achievement> definitions = {
+        {"first_study", {
+            "first_study",
+            "First Step",
+            "Study your first celestial body",
+            false, 0, 100
+        }},
+        {"planet_explorer", {
+            "planet_explorer",
+            "Planet Explorer",
+            "Study all planets of the Solar System",
+            false, 0, 500
+        }},
+        {"star_gazer", {
+            "star_gazer",
+            "Star Gazer",
+            "Study 5 different stars",
+            false, 0, 300
+        }},
+        {"quiz_beginner", {
+            "quiz_beginner",
+            "Beginner Astronomer",
+            "Complete your first quiz",
+            false, 0, 200
+        }},
+        {"quiz_master", {
+            "quiz_master",
+            "Quiz Master",
+            "Complete 10 quizzes",
+            false, 0, 1000
+        }},
+        {"perfect_score", {
+            "perfect_score",
+            "Perfection",
+            "Get 100% in a difficult quiz",
+            false, 0, 1500
+        }},
+        {"space_explorer", {
+            "space_explorer",
+            "Space Explorer",
+            "Study 20 different celestial bodies",
+            false, 0, 800
+        }}
     };
+    return definitions;
+}
+
+void Player::initializeAchievements() {
+    achievements = achievementDefinitions();
     
     std::cout << "Initialized " << achievements.size() << " achievements" << std::endl;
 }
@@ -357,6 +436,22 @@ bool Player::saveToFile(const std::string& filename) const {
     file << "\n[QuizHistory]\n";
     file << "count=" << quizHistory.size() << "\n";
     
+    file << "\n[PendingResults]\n";
+    for (size_t i = 0; i < pendingResults.size(); ++i) {
+        const auto& pending = pendingResults[i];
+        file << i << "=" << pending.score << "," << pending.correctAnswers
+             << "," << pending.totalQuestions << "," << pending.completedAt
+             << "," << pending.timeSpent << "," << pending.category << "\n";
+    }
+    
+    file << "\n[UnverifiedResults]\n";
+    for (size_t i = 0; i < unverifiedResults.size(); ++i) {
+        const auto& pending = unverifiedResults[i];
+        file << i << "=" << pending.score << "," << pending.correctAnswers
+             << "," << pending.totalQuestions << "," << pending.completedAt
+             << "," << pending.timeSpent << "," << pending.category << "\n";
+    }
+    
     file.close();
     return true;
 }
@@ -370,6 +465,8 @@ bool Player::loadFromFile(const std::string& filename) {
     
     std::string line;
     std::string currentSection;
+    std::vector<Database::QuizResultData> loadedPending;
+    std::vector<Database::QuizResultData> loadedUnverified;
     
     while (std::getline(file, line)) {
         if (line.empty() || line[0] == '#') {
@@ -409,10 +506,27 @@ bool Player::loadFromFile(const std::string& filename) {
                 }
             }
         }
+        else if (currentSection == "PendingResults" || currentSection == "UnverifiedResults") {
+            Database::QuizResultData pending;
+            if (!parsePendingResult(value, pending)) {
+                std::cerr << "Skipping malformed queued result in " << filename << ": " << line << std::endl;
+                continue;
+            }
+            
+            pending.playerName = name;
+            if (currentSection == "PendingResults") {
+                loadedPending.push_back(pending);
+            } else {
+                loadedUnverified.push_back(pending);
+            }
+        }
     }
     
     file.close();
     
+    pendingResults = loadedPending;
+    unverifiedResults = loadedUnverified;
+    
     std::cout << "Loaded savegame: " << name 
               << " (Score: " << totalScore << ")" << std::endl;
     return true;
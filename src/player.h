@@ -21,6 +21,8 @@ public:
     
     Player(const std::string& name);
     
+    static const std::map<std::string, Achievement>& achievementDefinitions();
+    
     bool initialize();
     
     void addScore(int points);
@@ -43,6 +45,15 @@ public:
     bool saveToDatabase();
     bool loadFromDatabase();
     bool syncWithDatabase();
+    // Results queued while the database was unreachable. Only results from
+    // a session that proved it owns the name are uploaded to an existing
+    // account; those played without logging in go only to an account this
+    // session registers, and are dropped otherwise.
+    void setAuthenticated(bool authenticated) { this->authenticated = authenticated; }
+    bool isAuthenticated() const { return authenticated; }
+    int flushPendingResults(bool newAccount);
+    bool hasPendingResults() const { return !pendingResults.empty() || !unverifiedResults.empty(); }
+    int getPendingResultsCount() const { return static_cast<int>(pendingResults.size() + unverifiedResults.size()); }
     
     bool saveToFile(const std::string& filename) const;
     bool loadFromFile(const std::string& filename);
@@ -56,11 +67,15 @@ private:
     std::map<std::string, int> studyProgress;
     std::map<std::string, Achievement> achievements;
     std::vector<Quiz::QuizResult> quizHistory;
+    bool authenticated;
+    std::vector<Database::QuizResultData> pendingResults;
+    std::vector<Database::QuizResultData> unverifiedResults;
     
     void initializeAchievements();
     
     Database::PlayerData toDatabaseStruct() const;
     void fromDatabaseStruct(const Database::PlayerData& data);
+    void applyProfile(const Database::PlayerProfile& profile);
 };
 
 #endif
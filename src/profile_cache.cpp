@@ -0,0 +1,141 @@
+#include "profile_cache.h"
+#include <algorithm>
+
+bool ProfileCache::lookup(const std::string& name, Database::PlayerProfile& profile) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    auto it = entries.find(name);
+    if (it == entries.end() || !it->second.hasAchievements) {
+        misses++;
+        return false;
+    }
+    
+    hits++;
+    profile = it->second.profile;
+    return true;
+}
+
+void ProfileCache::store(const Database::PlayerProfile& profile) {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    auto it = entries.find(profile.player.name);
+    if (it != entries.end() && it->second.profile.player.version > profile.player.version) {
+        return;
+    }
+    
+    Entry& entry = entries[profile.player.name];
+    entry.profile = profile;
+    entry.hasAchievements = true;
+}
+
+void ProfileCache::updatePlayer(const Database::PlayerData& player) {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    auto it = entries.find(player.name);
+    if (it == entries.end()) {
+        if (!rosterComplete) {
+            return;
+        }
+        it = entries.emplace(player.name, Entry{}).first;
+    } else if (it->second.profile.player.version > player.version) {
+        return;
+    }
+    
+    it->second.profile.player = player;
+}
+
+void ProfileCache::addAchievement(const Database::AchievementData& achievement, long long version) {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    auto it = entries.find(achievement.playerName);
+    if (it == entries.end()) {
+        return;
+    }
+    
+    Database::PlayerProfile& profile = it->second.profile;
+    bool known = std::any_of(profile.achievements.begin(), profile.achievements.end(),
+                             [&achievement](const Database::AchievementData& existing) {
+                                 return existing.achievementId == achievement.achievementId;
+                             });
+    if (!known) {
+        profile.achievements.insert(profile.achievements.begin(), achievement);
+    }
+    profile.player.version = std::max(profile.player.version, version);
+}
+
+void ProfileCache::erase(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    if (entries.erase(name) > 0) {
+        rosterComplete = false;
+    }
+}
+
+void ProfileCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    entries.clear();
+    rosterComplete = false;
+}
+
+bool ProfileCache::lookupRoster(std::vector<Database::PlayerData>& players) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    if (!rosterComplete) {
+        misses++;
+        return false;
+    }
+    
+    hits++;
+    players.clear();
+    players.reserve(entries.size());
+    for (const auto& [name, entry] : entries) {
+        players.push_back(entry.profile.player);
+    }
+    
+    std::stable_sort(players.begin(), players.end(),
+                     [](const Database::PlayerData& a, const Database::PlayerData& b) {
+                         return a.totalScore > b.totalScore;
+                     });
+    return true;
+}
+
+void ProfileCache::storeRoster(const std::vector<Database::PlayerData>& players) {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    std::map<std::string, Entry> fresh;
+    for (const auto& player : players) {
+        auto it = entries.find(player.name);
+        if (it != entries.end() && it->second.profile.player.version >= player.version) {
+            fresh.emplace(player.name, it->second);
+        } else {
+            Entry entry;
+            entry.profile.player = player;
+            fresh.emplace(player.name, entry);
+        }
+    }
+    
+    entries.swap(fresh);
+    rosterComplete = true;
+}
+
+int ProfileCache::dropStale(const std::map<std::string, long long>& currentVersions) {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    int dropped = 0;
+    for (auto it = entries.begin(); it != entries.end();) {
+        auto current = currentVersions.find(it->first);
+        if (current == currentVersions.end() || current->second != it->second.profile.player.version) {
+            it = entries.erase(it);
+            dropped++;
+        } else {
+            ++it;
+        }
+    }
+    
+    if (dropped > 0 || currentVersions.size() != entries.size()) {
+        rosterComplete = false;
+    }
+    
+    return dropped;
+}
@@ -0,0 +1,46 @@
+#ifndef PROFILE_CACHE_H
+#define PROFILE_CACHE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include "database.h"
+
+// In-process cache of player rows and their achievements, keyed by name.
+// Database writes through to it after every successful commit; entries
+// carry the row's version stamp so older data never replaces newer data.
+class ProfileCache {
+public:
+    bool lookup(const std::string& name, Database::PlayerProfile& profile) const;
+    void store(const Database::PlayerProfile& profile);
+    void updatePlayer(const Database::PlayerData& player);
+    void addAchievement(const Database::AchievementData& achievement, long long version);
+    void erase(const std::string& name);
+    void clear();
+    
+    bool lookupRoster(std::vector<Database::PlayerData>& players) const;
+    void storeRoster(const std::vector<Database::PlayerData>& players);
+    
+    // Drops every entry whose version differs from the given name -> version
+    // map; returns the number of entries dropped.
+    int dropStale(const std::map<std::string, long long>& currentVersions);
+    
+    int getHits() const { return hits; }
+    int getMisses() const { return misses; }
+
+private:
+    struct Entry {
+        Database::PlayerProfile profile;
+        bool hasAchievements = false;
+    };
+    
+    mutable std::mutex mutex;
+    std::map<std::string, Entry> entries;
+    bool rosterComplete = false;
+    
+    mutable int hits = 0;
+    mutable int misses = 0;
+};
+
+#endif
@@ -1195,6 +1195,10 @@ void Quiz::initializeQuestions() {
         "pluto", 2, 15
     });
     
+    for (size_t i = 0; i < questions.size(); ++i) {
+        questions[i].id = static_cast<int>(i);
+    }
+    
     std::cout << "Загружено " << questions.size() << " вопросов викторины" << std::endl;
 }
 
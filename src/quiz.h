@@ -15,6 +15,7 @@ public:
         std::string category;
         int difficulty;
         int points;
+        int id = -1;
     };
     
     struct QuizResult {
@@ -32,6 +33,8 @@ public:
     
     Quiz();
     
+    void seed(unsigned int value) { rng.seed(value); }
+    
     void startNewQuiz(const std::string& category = "", int questionCount = 10);
     bool submitAnswer(int answerIndex);
     void nextQuestion();
@@ -76,6 +79,7 @@ public:
     
     const std::vector<int>& getUserAnswers() const { return userAnswers; }
     const std::vector<Question>& getSelectedQuestions() const { return selectedQuestions; }
+    const std::vector<Question>& getQuestionBank() const { return questions; }
     
     void startRetryIncorrectQuestions(int requiredCorrect);
     bool hasRetryMode() const { return retryMode; }
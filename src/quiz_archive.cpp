@@ -0,0 +1,595 @@
+#include "quiz_archive.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <map>
+#include <cstdio>
+#include <cstdint>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace {
+
+const char ARCHIVE_MAGIC[4] = {'A', 'Q', 'R', 'A'};
+const std::uint8_t ARCHIVE_VERSION = 3;
+// Version 3 deflates consecutive player segments together in blocks of
+// about this size; single segments are too small for zlib to find much.
+const size_t BLOCK_BYTES = 64 * 1024;
+const size_t MAX_BLOCK_BYTES = 64 * 1024 * 1024;
+
+void putVarint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void putZigzag(std::string& out, std::int64_t value) {
+    putVarint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+void putString(std::string& out, const std::string& value) {
+    putVarint(out, value.size());
+    out += value;
+}
+
+void putRuns(std::string& out, const std::vector<std::uint64_t>& values) {
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> runs;
+    for (std::uint64_t value : values) {
+        if (!runs.empty() && runs.back().first == value) {
+            runs.back().second++;
+        } else {
+            runs.push_back({value, 1});
+        }
+    }
+    
+    putVarint(out, runs.size());
+    for (const auto& [value, length] : runs) {
+        putVarint(out, value);
+        putVarint(out, length);
+    }
+}
+
+class Reader {
+public:
+    Reader(const std::string& data, size_t begin = 0, size_t end = std::string::npos)
+        : data(data)
+        , pos(begin)
+        , end(std::min(end, data.size())) {}
+    
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        int shift = 0;
+        while (true) {
+            if (pos >= end || shift > 63) {
+                throw std::runtime_error("Corrupt quiz archive: truncated varint");
+            }
+            std::uint8_t byte = static_cast<std::uint8_t>(data[pos++]);
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+            shift += 7;
+        }
+    }
+    
+    std::int64_t zigzag() {
+        std::uint64_t raw = varint();
+        return static_cast<std::int64_t>(raw >> 1) ^ -static_cast<std::int64_t>(raw & 1);
+    }
+    
+    std::string string() {
+        std::uint64_t length = varint();
+        if (length > end - pos) {
+            throw std::runtime_error("Corrupt quiz archive: truncated string");
+        }
+        std::string value = data.substr(pos, length);
+        pos += length;
+        return value;
+    }
+    
+    std::vector<std::uint64_t> runs(size_t expectedCount) {
+        std::vector<std::uint64_t> values;
+        values.reserve(expectedCount);
+        std::uint64_t runCount = varint();
+        for (std::uint64_t i = 0; i < runCount; ++i) {
+            std::uint64_t value = varint();
+            std::uint64_t length = varint();
+            if (length > expectedCount - values.size()) {
+                throw std::runtime_error("Corrupt quiz archive: run overflows column");
+            }
+            values.insert(values.end(), length, value);
+        }
+        if (values.size() != expectedCount) {
+            throw std::runtime_error("Corrupt quiz archive: short column");
+        }
+        return values;
+    }
+
+private:
+    const std::string& data;
+    size_t pos;
+    size_t end;
+};
+
+struct IndexEntry {
+    std::string playerName;
+    size_t rowCount;
+    // Before version 3 offsets are into the data section, from version 3
+    // into the inflated block.
+    size_t block;
+    size_t offset;
+    size_t length;
+};
+
+struct Block {
+    size_t offset;
+    size_t length;
+    size_t rawLength;
+};
+
+struct Header {
+    std::uint8_t version = ARCHIVE_VERSION;
+    std::string term;
+    std::vector<std::string> categories;
+    std::vector<Block> blocks;
+    std::vector<IndexEntry> index;
+    size_t dataStart = 0;
+};
+
+std::string deflateBlock(const std::string& raw) {
+    uLongf length = compressBound(raw.size());
+    std::string out(length, '\0');
+    int status = compress2(reinterpret_cast<Bytef*>(&out[0]), &length,
+                           reinterpret_cast<const Bytef*>(raw.data()), raw.size(), Z_BEST_COMPRESSION);
+    if (status != Z_OK) {
+        throw std::runtime_error("Failed to compress quiz archive block");
+    }
+    out.resize(length);
+    return out;
+}
+
+std::string inflateBlock(const char* data, const Block& block) {
+    if (block.rawLength > MAX_BLOCK_BYTES) {
+        throw std::runtime_error("Corrupt quiz archive: block too large");
+    }
+    
+    std::string raw(block.rawLength, '\0');
+    uLongf length = block.rawLength;
+    int status = uncompress(reinterpret_cast<Bytef*>(&raw[0]), &length,
+                            reinterpret_cast<const Bytef*>(data), block.length);
+    if (status != Z_OK || length != block.rawLength) {
+        throw std::runtime_error("Corrupt quiz archive: bad compressed block");
+    }
+    return raw;
+}
+
+std::string encodeSegment(const std::vector<const Database::QuizResultData*>& rows,
+                          const std::map<std::string, std::uint64_t>& categoryIds) {
+    std::string out;
+    
+    std::time_t previous = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (i == 0) {
+            putZigzag(out, rows[i]->completedAt);
+        } else {
+            putVarint(out, static_cast<std::uint64_t>(rows[i]->completedAt - previous));
+        }
+        previous = rows[i]->completedAt;
+    }
+    
+    for (const auto* row : rows) {
+        putZigzag(out, row->score);
+    }
+    
+    for (const auto* row : rows) {
+        putVarint(out, static_cast<std::uint64_t>(std::max(row->correctAnswers, 0)));
+    }
+    
+    for (const auto* row : rows) {
+        putVarint(out, static_cast<std::uint64_t>(std::max(row->timeSpent, 0)));
+    }
+    
+    std::vector<std::uint64_t> totals;
+    std::vector<std::uint64_t> categories;
+    for (const auto* row : rows) {
+        totals.push_back(static_cast<std::uint64_t>(std::max(row->totalQuestions, 0)));
+        categories.push_back(categoryIds.at(row->category));
+    }
+    putRuns(out, totals);
+    putRuns(out, categories);
+    
+    return out;
+}
+
+void decodeSegment(const std::string& data, size_t begin, const IndexEntry& entry,
+                   const Header& header,
+                   const std::function<void(const Database::QuizResultData&)>& visitor) {
+    Reader reader(data, begin, begin + entry.length);
+    size_t count = entry.rowCount;
+    
+    std::vector<std::time_t> completedAt(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (i == 0) {
+            completedAt[i] = static_cast<std::time_t>(reader.zigzag());
+        } else {
+            completedAt[i] = completedAt[i - 1] + static_cast<std::time_t>(reader.varint());
+        }
+    }
+    
+    std::vector<int> scores(count);
+    for (size_t i = 0; i < count; ++i) {
+        scores[i] = static_cast<int>(reader.zigzag());
+    }
+    
+    std::vector<int> correct(count);
+    for (size_t i = 0; i < count; ++i) {
+        correct[i] = static_cast<int>(reader.varint());
+    }
+    
+    std::vector<int> timeSpent(count, 0);
+    if (header.version >= 2) {
+        for (size_t i = 0; i < count; ++i) {
+            timeSpent[i] = static_cast<int>(reader.varint());
+        }
+    }
+    
+    std::vector<std::uint64_t> totals = reader.runs(count);
+    std::vector<std::uint64_t> categoryIds = reader.runs(count);
+    
+    for (size_t i = 0; i < count; ++i) {
+        if (categoryIds[i] >= header.categories.size()) {
+            throw std::runtime_error("Corrupt quiz archive: unknown category id");
+        }
+        
+        Database::QuizResultData row;
+        row.playerName = entry.playerName;
+        row.score = scores[i];
+        row.correctAnswers = correct[i];
+        row.totalQuestions = static_cast<int>(totals[i]);
+        row.category = header.categories[categoryIds[i]];
+        row.completedAt = completedAt[i];
+        row.timeSpent = timeSpent[i];
+        visitor(row);
+    }
+}
+
+bool readHeader(std::ifstream& file, const std::string& path, Header& header) {
+    char magic[4];
+    if (!file.read(magic, 4) || !std::equal(magic, magic + 4, ARCHIVE_MAGIC)) {
+        std::cerr << "Not a quiz archive: " << path << std::endl;
+        return false;
+    }
+    
+    char sizeBytes[5];
+    if (!file.read(sizeBytes, 5)) {
+        std::cerr << "Truncated quiz archive: " << path << std::endl;
+        return false;
+    }
+    
+    header.version = static_cast<std::uint8_t>(sizeBytes[0]);
+    if (header.version < 1 || header.version > ARCHIVE_VERSION) {
+        std::cerr << "Unsupported quiz archive version in " << path << std::endl;
+        return false;
+    }
+    
+    std::uint32_t headerSize = 0;
+    for (int i = 0; i < 4; ++i) {
+        headerSize |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(sizeBytes[1 + i])) << (8 * i);
+    }
+    
+    std::string headerBytes(headerSize, '\0');
+    if (!file.read(&headerBytes[0], headerSize)) {
+        std::cerr << "Truncated quiz archive header: " << path << std::endl;
+        return false;
+    }
+    
+    Reader reader(headerBytes);
+    header.term = reader.string();
+    
+    std::uint64_t categoryCount = reader.varint();
+    for (std::uint64_t i = 0; i < categoryCount; ++i) {
+        header.categories.push_back(reader.string());
+    }
+    
+    if (header.version >= 3) {
+        std::uint64_t blockCount = reader.varint();
+        for (std::uint64_t i = 0; i < blockCount; ++i) {
+            Block block;
+            block.offset = reader.varint();
+            block.length = reader.varint();
+            block.rawLength = reader.varint();
+            header.blocks.push_back(block);
+        }
+    }
+    
+    std::uint64_t playerCount = reader.varint();
+    for (std::uint64_t i = 0; i < playerCount; ++i) {
+        IndexEntry entry;
+        entry.playerName = reader.string();
+        entry.rowCount = reader.varint();
+        entry.block = 0;
+        if (header.version >= 3) {
+            entry.block = reader.varint();
+            if (entry.block >= header.blocks.size()) {
+                throw std::runtime_error("Corrupt quiz archive: unknown block");
+            }
+        }
+        entry.offset = reader.varint();
+        entry.length = reader.varint();
+        header.index.push_back(entry);
+    }
+    
+    header.dataStart = 9 + headerSize;
+    return true;
+}
+
+}
+
+std::string QuizArchive::termForTime(std::time_t time) {
+    std::tm* tm = std::localtime(&time);
+    int year = tm->tm_year + 1900;
+    int month = tm->tm_mon + 1;
+    
+    if (month >= 9) {
+        return std::to_string(year) + "-2";
+    }
+    if (month == 1) {
+        return std::to_string(year - 1) + "-2";
+    }
+    return std::to_string(year) + "-1";
+}
+
+std::string QuizArchive::archivePath(const std::string& archiveDir, const std::string& term) {
+    return archiveDir + "/quiz_results_" + term + ".qra";
+}
+
+bool QuizArchive::writeTerm(const std::string& path, const std::string& term,
+                            std::vector<Database::QuizResultData> rows) {
+    std::ifstream existing(path, std::ios::binary);
+    if (existing.good()) {
+        existing.close();
+        if (!readAll(path, rows)) {
+            std::cerr << "Refusing to overwrite unreadable quiz archive: " << path << std::endl;
+            return false;
+        }
+    }
+    
+    std::stable_sort(rows.begin(), rows.end(),
+                     [](const Database::QuizResultData& a, const Database::QuizResultData& b) {
+                         if (a.playerName != b.playerName) {
+                             return a.playerName < b.playerName;
+                         }
+                         return a.completedAt < b.completedAt;
+                     });
+    
+    std::map<std::string, std::uint64_t> categoryIds;
+    std::vector<std::string> categories;
+    for (const auto& row : rows) {
+        if (categoryIds.emplace(row.category, categories.size()).second) {
+            categories.push_back(row.category);
+        }
+    }
+    
+    std::vector<IndexEntry> index;
+    std::vector<Block> blocks;
+    std::string data;
+    std::string block;
+    
+    auto flushBlock = [&]() {
+        std::string compressed = deflateBlock(block);
+        blocks.push_back({data.size(), compressed.size(), block.size()});
+        data += compressed;
+        block.clear();
+    };
+    
+    try {
+        size_t groupStart = 0;
+        while (groupStart < rows.size()) {
+            size_t groupEnd = groupStart;
+            std::vector<const Database::QuizResultData*> group;
+            while (groupEnd < rows.size() && rows[groupEnd].playerName == rows[groupStart].playerName) {
+                group.push_back(&rows[groupEnd]);
+                groupEnd++;
+            }
+            
+            std::string segment = encodeSegment(group, categoryIds);
+            index.push_back({rows[groupStart].playerName, group.size(), blocks.size(), block.size(), segment.size()});
+            block += segment;
+            if (block.size() >= BLOCK_BYTES) {
+                flushBlock();
+            }
+            
+            groupStart = groupEnd;
+        }
+        if (!block.empty()) {
+            flushBlock();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to encode quiz archive " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+    
+    std::string header;
+    putString(header, term);
+    putVarint(header, categories.size());
+    for (const auto& category : categories) {
+        putString(header, category);
+    }
+    putVarint(header, blocks.size());
+    for (const auto& entry : blocks) {
+        putVarint(header, entry.offset);
+        putVarint(header, entry.length);
+        putVarint(header, entry.rawLength);
+    }
+    putVarint(header, index.size());
+    for (const auto& entry : index) {
+        putString(header, entry.playerName);
+        putVarint(header, entry.rowCount);
+        putVarint(header, entry.block);
+        putVarint(header, entry.offset);
+        putVarint(header, entry.length);
+    }
+    
+    std::string tmpPath = path + ".tmp";
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open quiz archive for writing: " << tmpPath << std::endl;
+        return false;
+    }
+    
+    std::uint32_t headerSize = static_cast<std::uint32_t>(header.size());
+    file.write(ARCHIVE_MAGIC, 4);
+    file.put(static_cast<char>(ARCHIVE_VERSION));
+    for (int i = 0; i < 4; ++i) {
+        file.put(static_cast<char>((headerSize >> (8 * i)) & 0xFF));
+    }
+    file << header << data;
+    file.close();
+    
+    if (!file) {
+        std::cerr << "Failed to write quiz archive: " << tmpPath << std::endl;
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    
+    std::string backupPath = path + ".bak";
+    std::remove(backupPath.c_str());
+    std::rename(path.c_str(), backupPath.c_str());
+    
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to move quiz archive into place: " << path << std::endl;
+        std::rename(backupPath.c_str(), path.c_str());
+        return false;
+    }
+    
+    std::cout << "Quiz archive " << path << " written: " << rows.size() << " results, "
+              << index.size() << " players, " << (9 + header.size() + data.size()) << " bytes" << std::endl;
+    return true;
+}
+
+void QuizArchive::discardBackup(const std::string& path) {
+    std::remove((path + ".bak").c_str());
+}
+
+void QuizArchive::restoreBackup(const std::string& path) {
+    std::string backupPath = path + ".bak";
+    std::ifstream backup(backupPath, std::ios::binary);
+    if (backup.good()) {
+        backup.close();
+        std::rename(backupPath.c_str(), path.c_str());
+    } else {
+        std::remove(path.c_str());
+    }
+}
+
+bool QuizArchive::readAll(const std::string& path, std::vector<Database::QuizResultData>& rows) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Quiz archive not found: " << path << std::endl;
+        return false;
+    }
+    
+    try {
+        Header header;
+        if (!readHeader(file, path, header)) {
+            return false;
+        }
+        
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        std::string data = buffer.str();
+        
+        std::vector<std::string> inflated;
+        for (const auto& block : header.blocks) {
+            if (block.offset + block.length > data.size()) {
+                throw std::runtime_error("Corrupt quiz archive: block out of range");
+            }
+            inflated.push_back(inflateBlock(data.data() + block.offset, block));
+        }
+        
+        for (const auto& entry : header.index) {
+            const std::string& source = header.version >= 3 ? inflated[entry.block] : data;
+            if (entry.offset + entry.length > source.size()) {
+                throw std::runtime_error("Corrupt quiz archive: segment out of range");
+            }
+            decodeSegment(source, entry.offset, entry, header,
+                          [&rows](const Database::QuizResultData& row) { rows.push_back(row); });
+        }
+        return true;
+    
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to read quiz archive " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool QuizArchive::forEachPlayerResult(const std::string& path, const std::string& playerName,
+                                      const std::function<void(const Database::QuizResultData&)>& visitor) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Quiz archive not found: " << path << std::endl;
+        return false;
+    }
+    
+    try {
+        Header header;
+        if (!readHeader(file, path, header)) {
+            return false;
+        }
+        
+        auto it = std::find_if(header.index.begin(), header.index.end(),
+                               [&playerName](const IndexEntry& entry) { return entry.playerName == playerName; });
+        if (it == header.index.end()) {
+            return true;
+        }
+        
+        if (header.version < 3) {
+            std::string segment(it->length, '\0');
+            file.seekg(static_cast<std::streamoff>(header.dataStart + it->offset));
+            if (!file.read(&segment[0], it->length)) {
+                throw std::runtime_error("Corrupt quiz archive: segment out of range");
+            }
+            decodeSegment(segment, 0, *it, header, visitor);
+            return true;
+        }
+        
+        const Block& block = header.blocks[it->block];
+        std::string compressed(block.length, '\0');
+        file.seekg(static_cast<std::streamoff>(header.dataStart + block.offset));
+        if (!file.read(&compressed[0], block.length)) {
+            throw std::runtime_error("Corrupt quiz archive: block out of range");
+        }
+        
+        std::string raw = inflateBlock(compressed.data(), block);
+        if (it->offset + it->length > raw.size()) {
+            throw std::runtime_error("Corrupt quiz archive: segment out of range");
+        }
+        decodeSegment(raw, it->offset, *it, header, visitor);
+        return true;
+    
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to read quiz archive " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+std::vector<QuizArchive::PlayerSegment> QuizArchive::summarize(const std::vector<Database::QuizResultData>& rows) {
+    std::map<std::string, PlayerSegment> byPlayer;
+    for (const auto& row : rows) {
+        auto& summary = byPlayer[row.playerName];
+        summary.playerName = row.playerName;
+        summary.rowCount++;
+        summary.totalScore += row.score;
+        summary.correctAnswers += row.correctAnswers;
+        summary.totalQuestions += row.totalQuestions;
+    }
+    
+    std::vector<PlayerSegment> result;
+    for (const auto& [name, summary] : byPlayer) {
+        result.push_back(summary);
+    }
+    return result;
+}
@@ -0,0 +1,43 @@
+#ifndef QUIZ_ARCHIVE_H
+#define QUIZ_ARCHIVE_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <ctime>
+#include "database.h"
+
+// Cold storage for old quiz_results rows: one file per school term
+// ("YYYY-1" is the spring term, "YYYY-2" the autumn term incl. January).
+// Rows are grouped by player; inside a group every field is stored as its
+// own column (delta/varint/RLE/dictionary encoded). Consecutive groups are
+// deflated together in blocks of about 64 KiB, and an index in the header
+// lets a single player's rows be read by inflating only their block.
+class QuizArchive {
+public:
+    struct PlayerSegment {
+        std::string playerName;
+        int rowCount;
+        int totalScore;
+        int correctAnswers;
+        int totalQuestions;
+    };
+    
+    static std::string termForTime(std::time_t time);
+    static std::string archivePath(const std::string& archiveDir, const std::string& term);
+    
+    // Merges rows into the term file. The previous file is kept as
+    // <path>.bak until discardBackup/restoreBackup is called.
+    static bool writeTerm(const std::string& path, const std::string& term,
+                          std::vector<Database::QuizResultData> rows);
+    static void discardBackup(const std::string& path);
+    static void restoreBackup(const std::string& path);
+    
+    static bool readAll(const std::string& path, std::vector<Database::QuizResultData>& rows);
+    static bool forEachPlayerResult(const std::string& path, const std::string& playerName,
+                                    const std::function<void(const Database::QuizResultData&)>& visitor);
+    
+    static std::vector<PlayerSegment> summarize(const std::vector<Database::QuizResultData>& rows);
+};
+
+#endif
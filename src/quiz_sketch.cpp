@@ -0,0 +1,309 @@
+#include "quiz_sketch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+void putDouble(std::string& out, double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+}
+
+double getDouble(const std::string& data, size_t& pos) {
+    if (pos + 8 > data.size()) {
+        throw std::runtime_error("Corrupt quiz sketch: truncated digest");
+    }
+    std::uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+        bits |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(data[pos + i])) << (8 * i);
+    }
+    pos += 8;
+    
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+}
+
+HyperLogLog::HyperLogLog(int precision)
+    : precision(precision)
+    , registers(static_cast<size_t>(1) << precision, 0) {
+}
+
+std::uint64_t HyperLogLog::hash(const std::string& value) {
+    std::uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : value) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+void HyperLogLog::add(const std::string& value) {
+    std::uint64_t h = hash(value);
+    size_t index = static_cast<size_t>(h >> (64 - precision));
+    std::uint64_t rest = (h << precision) | (static_cast<std::uint64_t>(1) << (precision - 1));
+    
+    std::uint8_t rank = 1;
+    while ((rest & (static_cast<std::uint64_t>(1) << 63)) == 0) {
+        rank++;
+        rest <<= 1;
+    }
+    
+    registers[index] = std::max(registers[index], rank);
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.precision != precision) {
+        throw std::invalid_argument("Cannot merge HyperLogLog sketches of different precision");
+    }
+    for (size_t i = 0; i < registers.size(); ++i) {
+        registers[i] = std::max(registers[i], other.registers[i]);
+    }
+}
+
+double HyperLogLog::estimate() const {
+    double m = static_cast<double>(registers.size());
+    double sum = 0.0;
+    int zeros = 0;
+    for (std::uint8_t value : registers) {
+        sum += std::ldexp(1.0, -value);
+        if (value == 0) {
+            zeros++;
+        }
+    }
+    
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double raw = alpha * m * m / sum;
+    
+    if (raw <= 2.5 * m && zeros > 0) {
+        return m * std::log(m / zeros);
+    }
+    return raw;
+}
+
+std::string HyperLogLog::serialize() const {
+    std::string out;
+    out.push_back(static_cast<char>(precision));
+    out.append(registers.begin(), registers.end());
+    return out;
+}
+
+HyperLogLog HyperLogLog::deserialize(const std::string& data) {
+    if (data.empty()) {
+        return HyperLogLog();
+    }
+    
+    int precision = static_cast<std::uint8_t>(data[0]);
+    if (precision < 4 || precision > 16 || data.size() != 1 + (static_cast<size_t>(1) << precision)) {
+        throw std::runtime_error("Corrupt quiz sketch: bad HyperLogLog registers");
+    }
+    
+    HyperLogLog sketch(precision);
+    std::copy(data.begin() + 1, data.end(), sketch.registers.begin());
+    return sketch;
+}
+
+TDigest::TDigest(double compression)
+    : compression(compression)
+    , totalWeight(0.0)
+    , minValue(0.0)
+    , maxValue(0.0) {
+}
+
+void TDigest::add(double value, double weight) {
+    if (totalWeight == 0.0) {
+        minValue = value;
+        maxValue = value;
+    } else {
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+    
+    unmerged.push_back({value, weight});
+    totalWeight += weight;
+    
+    if (unmerged.size() > static_cast<size_t>(compression * 4)) {
+        compress();
+    }
+}
+
+void TDigest::merge(const TDigest& other) {
+    if (other.totalWeight == 0.0) {
+        return;
+    }
+    
+    other.compress();
+    if (totalWeight == 0.0) {
+        minValue = other.minValue;
+        maxValue = other.maxValue;
+    } else {
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+    
+    unmerged.insert(unmerged.end(), other.centroids.begin(), other.centroids.end());
+    totalWeight += other.totalWeight;
+    compress();
+}
+
+void TDigest::compress() const {
+    if (unmerged.empty()) {
+        return;
+    }
+    
+    std::vector<Centroid> all;
+    all.reserve(centroids.size() + unmerged.size());
+    all.insert(all.end(), centroids.begin(), centroids.end());
+    all.insert(all.end(), unmerged.begin(), unmerged.end());
+    unmerged.clear();
+    
+    std::sort(all.begin(), all.end(),
+              [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+    
+    centroids.clear();
+    Centroid current = all[0];
+    double weightSoFar = 0.0;
+    
+    for (size_t i = 1; i < all.size(); ++i) {
+        double proposed = current.weight + all[i].weight;
+        double q0 = weightSoFar / totalWeight;
+        double q2 = (weightSoFar + proposed) / totalWeight;
+        double limit = totalWeight * 4.0 * std::min(q0 * (1.0 - q0), q2 * (1.0 - q2)) / compression;
+        
+        if (proposed <= std::max(limit, 1.0)) {
+            current.mean += (all[i].mean - current.mean) * all[i].weight / proposed;
+            current.weight = proposed;
+        } else {
+            weightSoFar += current.weight;
+            centroids.push_back(current);
+            current = all[i];
+        }
+    }
+    centroids.push_back(current);
+}
+
+double TDigest::quantile(double q) const {
+    compress();
+    
+    if (centroids.empty()) {
+        return 0.0;
+    }
+    if (centroids.size() == 1) {
+        return centroids[0].mean;
+    }
+    
+    q = std::min(std::max(q, 0.0), 1.0);
+    double target = q * totalWeight;
+    double cumulative = 0.0;
+    
+    for (size_t i = 0; i < centroids.size(); ++i) {
+        double center = cumulative + centroids[i].weight / 2.0;
+        if (target < center) {
+            double fromValue = i == 0 ? minValue : centroids[i - 1].mean;
+            double fromRank = i == 0 ? 0.0 : cumulative - centroids[i - 1].weight / 2.0;
+            double span = center - fromRank;
+            double t = span > 0.0 ? (target - fromRank) / span : 1.0;
+            return fromValue + (centroids[i].mean - fromValue) * t;
+        }
+        cumulative += centroids[i].weight;
+    }
+    
+    double lastCenter = totalWeight - centroids.back().weight / 2.0;
+    double span = totalWeight - lastCenter;
+    double t = span > 0.0 ? (target - lastCenter) / span : 1.0;
+    return centroids.back().mean + (maxValue - centroids.back().mean) * t;
+}
+
+std::string TDigest::serialize() const {
+    compress();
+    
+    std::string out;
+    putDouble(out, compression);
+    putDouble(out, minValue);
+    putDouble(out, maxValue);
+    putDouble(out, static_cast<double>(centroids.size()));
+    for (const auto& centroid : centroids) {
+        putDouble(out, centroid.mean);
+        putDouble(out, centroid.weight);
+    }
+    return out;
+}
+
+TDigest TDigest::deserialize(const std::string& data) {
+    if (data.empty()) {
+        return TDigest();
+    }
+    
+    size_t pos = 0;
+    TDigest digest(getDouble(data, pos));
+    digest.minValue = getDouble(data, pos);
+    digest.maxValue = getDouble(data, pos);
+    
+    size_t count = static_cast<size_t>(getDouble(data, pos));
+    if (count > (data.size() - pos) / 16) {
+        throw std::runtime_error("Corrupt quiz sketch: bad centroid count");
+    }
+    
+    for (size_t i = 0; i < count; ++i) {
+        Centroid centroid;
+        centroid.mean = getDouble(data, pos);
+        centroid.weight = getDouble(data, pos);
+        digest.centroids.push_back(centroid);
+        digest.totalWeight += centroid.weight;
+    }
+    return digest;
+}
+
+void QuizSketch::add(const Database::QuizResultData& result) {
+    players.add(result.playerName);
+    scores.add(result.score);
+    timesSpent.add(result.timeSpent);
+    quizCount++;
+}
+
+void QuizSketch::merge(const QuizSketch& other) {
+    players.merge(other.players);
+    scores.merge(other.scores);
+    timesSpent.merge(other.timesSpent);
+    quizCount += other.quizCount;
+}
+
+std::string QuizSketch::toHex(const std::string& bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(bytes.size() * 2);
+    for (unsigned char c : bytes) {
+        hex.push_back(digits[c >> 4]);
+        hex.push_back(digits[c & 0x0F]);
+    }
+    return hex;
+}
+
+std::string QuizSketch::fromHex(const std::string& hex) {
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        throw std::runtime_error("Corrupt quiz sketch: bad hex digit");
+    };
+    
+    std::string bytes;
+    bytes.reserve(hex.size() / 2);
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        bytes.push_back(static_cast<char>((nibble(hex[i]) << 4) | nibble(hex[i + 1])));
+    }
+    return bytes;
+}
@@ -0,0 +1,73 @@
+#ifndef QUIZ_SKETCH_H
+#define QUIZ_SKETCH_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "database.h"
+
+// Distinct-count estimator. Registers are persisted, so the hash must be
+// stable across runs and platforms (std::hash is not).
+class HyperLogLog {
+public:
+    explicit HyperLogLog(int precision = 10);
+    
+    void add(const std::string& value);
+    void merge(const HyperLogLog& other);
+    double estimate() const;
+    
+    std::string serialize() const;
+    static HyperLogLog deserialize(const std::string& data);
+
+private:
+    int precision;
+    std::vector<std::uint8_t> registers;
+    
+    static std::uint64_t hash(const std::string& value);
+};
+
+// Merging t-digest: a sorted list of weighted centroids that stays small
+// near the median and fine-grained in the tails.
+class TDigest {
+public:
+    explicit TDigest(double compression = 100.0);
+    
+    void add(double value, double weight = 1.0);
+    void merge(const TDigest& other);
+    double quantile(double q) const;
+    double count() const { return totalWeight; }
+    
+    std::string serialize() const;
+    static TDigest deserialize(const std::string& data);
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+    
+    double compression;
+    double totalWeight;
+    double minValue;
+    double maxValue;
+    mutable std::vector<Centroid> centroids;
+    mutable std::vector<Centroid> unmerged;
+    
+    void compress() const;
+};
+
+// Per (day, category) aggregate fed by every saved quiz result.
+struct QuizSketch {
+    HyperLogLog players;
+    TDigest scores;
+    TDigest timesSpent;
+    int quizCount = 0;
+    
+    void add(const Database::QuizResultData& result);
+    void merge(const QuizSketch& other);
+    
+    static std::string toHex(const std::string& bytes);
+    static std::string fromHex(const std::string& hex);
+};
+
+#endif
@@ -0,0 +1,106 @@
+#include "render_thread.h"
+#include <iostream>
+
+RenderThread::RenderThread(sf::RenderWindow& window)
+    : window(window)
+    , middle(1)
+    , writing(0)
+    , reading(2)
+    , running(false)
+    , presentedFrames(0)
+    , submitMicros(0)
+    , displayMicros(0) {
+}
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+void RenderThread::start() {
+    if (running) {
+        return;
+    }
+    
+    defaultView = window.getDefaultView();
+    for (auto& buffer : buffers) {
+        buffer.reset();
+        buffer.setView(defaultView);
+    }
+    
+    window.setActive(false);
+    running = true;
+    thread = std::thread(&RenderThread::loop, this);
+    std::cout << "Render thread started" << std::endl;
+}
+
+void RenderThread::stop() {
+    if (!running) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        running = false;
+    }
+    wake.notify_one();
+    thread.join();
+    
+    window.setActive(true);
+    std::cout << "Render thread stopped after " << presentedFrames << " frames" << std::endl;
+}
+
+DrawList& RenderThread::beginFrame() {
+    DrawList& list = buffers[writing];
+    list.reset();
+    list.setView(defaultView);
+    return list;
+}
+
+void RenderThread::publish() {
+    writing = middle.exchange(writing | FRESH) & INDEX_MASK;
+    
+    // Only orders the wake-up against the render thread's wait; the frame
+    // itself was handed over by the exchange above.
+    { std::lock_guard<std::mutex> lock(wakeMutex); }
+    wake.notify_one();
+}
+
+bool RenderThread::isReadyForFrame() const {
+    return (middle.load() & FRESH) == 0;
+}
+
+void RenderThread::loop() {
+    window.setActive(true);
+    
+    while (running) {
+        if ((middle.load() & FRESH) == 0) {
+            capture.flush();
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, std::chrono::milliseconds(100), [this]() {
+                return !running || (middle.load() & FRESH) != 0;
+            });
+            continue;
+        }
+        
+        reading = middle.exchange(reading) & INDEX_MASK;
+        
+        sf::Clock phaseClock;
+        {
+            std::lock_guard<std::mutex> lock(resourceMutex);
+            resolution.submit(buffers[reading], window);
+        }
+        resolution.finish();
+        submitMicros = phaseClock.restart().asMicroseconds();
+        resolution.update(sf::microseconds(submitMicros));
+        
+        capture.capture(window.getSize());
+        pacer.waitForPresent(sf::microseconds(submitMicros));
+        window.display();
+        pacer.presented();
+        displayMicros = phaseClock.getElapsedTime().asMicroseconds();
+        presentedFrames++;
+    }
+    
+    capture.release();
+    window.setActive(false);
+}
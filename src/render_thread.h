@@ -0,0 +1,79 @@
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "draw_list.h"
+#include "dynamic_resolution.h"
+#include "frame_capture.h"
+#include "frame_pacer.h"
+
+// Owns the window's GL context and presents DrawLists recorded by the main
+// thread. Frames are exchanged through a lock-free triple buffer: the main
+// thread always has a list to record into, the render thread always has
+// the latest complete one, and neither waits for the other's display().
+//
+// Fonts and textures are shared with the main thread (glyphs are rasterised
+// lazily and textures are uploaded by ResourceCache), so both sides hold
+// getResourceMutex() while touching them: the main thread while recording,
+// the render thread while submitting, but not while presenting.
+class RenderThread {
+public:
+    explicit RenderThread(sf::RenderWindow& window);
+    ~RenderThread();
+    
+    void start();
+    void stop();
+    bool isRunning() const { return running; }
+    
+    // Main thread: returns an empty list to record the next frame into.
+    DrawList& beginFrame();
+    void publish();
+    
+    // True once the render thread picked up the last published frame.
+    bool isReadyForFrame() const;
+    
+    std::mutex& getResourceMutex() { return resourceMutex; }
+    
+    // Configure before start().
+    DynamicResolution& getDynamicResolution() { return resolution; }
+    // Screenshots and recording read back the presented frames here.
+    FrameCapture& getCapture() { return capture; }
+    FramePacer& getPacer() { return pacer; }
+    unsigned long getPresentedFrames() const { return presentedFrames; }
+    
+    // Timings of the most recently presented frame.
+    sf::Time getSubmitTime() const { return sf::microseconds(submitMicros); }
+    sf::Time getDisplayTime() const { return sf::microseconds(displayMicros); }
+
+private:
+    static const int FRESH = 4;
+    static const int INDEX_MASK = 3;
+    
+    sf::RenderWindow& window;
+    sf::View defaultView;
+    DynamicResolution resolution;
+    FrameCapture capture;
+    FramePacer pacer;
+    DrawList buffers[3];
+    std::atomic<int> middle;
+    int writing;
+    int reading;
+    
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<unsigned long> presentedFrames;
+    std::atomic<sf::Int64> submitMicros;
+    std::atomic<sf::Int64> displayMicros;
+    
+    std::mutex resourceMutex;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    
+    void loop();
+};
+
+#endif
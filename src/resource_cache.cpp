@@ -0,0 +1,242 @@
+#include "resource_cache.h"
+#include <iostream>
+#include <algorithm>
+
+namespace {
+
+const unsigned int ATLAS_SIZE = 1024;
+const unsigned int ATLAS_MAX_IMAGE = 256;
+const unsigned int ATLAS_PADDING = 1;
+const int WORKER_COUNT = 2;
+
+}
+
+ResourceCache& ResourceCache::getInstance() {
+    static ResourceCache instance;
+    return instance;
+}
+
+ResourceCache::ResourceCache()
+    : stopping(false)
+    , inFlight(0)
+    , loadedCount(0)
+    , atlasedCount(0)
+    , decodeTotalMs(0.0)
+    , uploadTotalMs(0.0)
+    , slowestMs(0.0)
+    , reported(false) {
+    
+    for (int i = 0; i < WORKER_COUNT; ++i) {
+        workers.emplace_back(&ResourceCache::workerLoop, this);
+    }
+}
+
+ResourceCache::~ResourceCache() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_all();
+    
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ResourceCache::TextureHandle ResourceCache::loadTexture(const std::string& path) {
+    TextureHandle handle;
+    
+    auto it = textures.find(path);
+    if (it != textures.end()) {
+        handle.slot = it->second;
+        return handle;
+    }
+    
+    handle.slot = std::make_shared<TextureHandle::Slot>();
+    textures[path] = handle.slot;
+    
+    Request request;
+    request.path = path;
+    request.slot = handle.slot;
+    request.queuedAt = Clock::now();
+    
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (inFlight == 0 && pendingDecode.empty() && decodedQueue.empty()) {
+            firstRequestAt = request.queuedAt;
+            reported = false;
+        }
+        pendingDecode.push_back(std::move(request));
+        inFlight++;
+    }
+    queueReady.notify_one();
+    
+    return handle;
+}
+
+sf::Font* ResourceCache::loadFont(const std::vector<std::string>& candidatePaths) {
+    for (const auto& path : candidatePaths) {
+        auto it = fonts.find(path);
+        if (it != fonts.end()) {
+            return it->second.get();
+        }
+        
+        auto font = std::make_unique<sf::Font>();
+        if (font->loadFromFile(path)) {
+            std::cout << "Font loaded from: " << path << std::endl;
+            sf::Font* result = font.get();
+            fonts[path] = std::move(font);
+            return result;
+        }
+    }
+    return nullptr;
+}
+
+void ResourceCache::workerLoop() {
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this]() { return stopping || !pendingDecode.empty(); });
+            if (stopping) {
+                return;
+            }
+            request = std::move(pendingDecode.front());
+            pendingDecode.pop_front();
+        }
+        
+        auto start = Clock::now();
+        request.decoded = request.image.loadFromFile(request.path);
+        request.decodeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        
+        std::lock_guard<std::mutex> lock(queueMutex);
+        decodedQueue.push_back(std::move(request));
+    }
+}
+
+int ResourceCache::pump() {
+    std::deque<Request> ready;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        ready.swap(decodedQueue);
+    }
+    
+    for (auto& request : ready) {
+        upload(request);
+    }
+    
+    if (!ready.empty()) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        inFlight -= static_cast<int>(ready.size());
+    }
+    
+    if (!reported && getPendingCount() == 0 && (loadedCount > 0 || !missingPaths.empty())) {
+        reportTimings();
+        reported = true;
+    }
+    
+    return static_cast<int>(ready.size());
+}
+
+int ResourceCache::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return inFlight;
+}
+
+void ResourceCache::upload(Request& request) {
+    decodeTotalMs += request.decodeMs;
+    
+    if (!request.decoded) {
+        request.slot->state = TextureHandle::State::FAILED;
+        missingPaths.push_back(request.path);
+        return;
+    }
+    
+    auto start = Clock::now();
+    
+    const sf::Texture* texture = nullptr;
+    sf::IntRect rect;
+    if (placeInAtlas(request.image, texture, rect)) {
+        atlasedCount++;
+    } else {
+        auto standalone = std::make_unique<sf::Texture>();
+        if (!standalone->loadFromImage(request.image)) {
+            request.slot->state = TextureHandle::State::FAILED;
+            missingPaths.push_back(request.path);
+            return;
+        }
+        standalone->setSmooth(true);
+        sf::Vector2u size = standalone->getSize();
+        rect = sf::IntRect(0, 0, static_cast<int>(size.x), static_cast<int>(size.y));
+        texture = standalone.get();
+        standaloneTextures.push_back(std::move(standalone));
+    }
+    
+    auto end = Clock::now();
+    uploadTotalMs += std::chrono::duration<double, std::milli>(end - start).count();
+    slowestMs = std::max(slowestMs, std::chrono::duration<double, std::milli>(end - request.queuedAt).count());
+    
+    request.slot->texture = texture;
+    request.slot->rect = rect;
+    request.slot->state = TextureHandle::State::READY;
+    loadedCount++;
+}
+
+bool ResourceCache::placeInAtlas(const sf::Image& image, const sf::Texture*& texture, sf::IntRect& rect) {
+    sf::Vector2u size = image.getSize();
+    if (size.x > ATLAS_MAX_IMAGE || size.y > ATLAS_MAX_IMAGE) {
+        return false;
+    }
+    
+    unsigned int width = size.x + ATLAS_PADDING;
+    unsigned int height = size.y + ATLAS_PADDING;
+    
+    for (auto& atlas : atlases) {
+        if (atlas.shelfX + width > ATLAS_SIZE) {
+            atlas.shelfX = 0;
+            atlas.shelfY += atlas.shelfHeight;
+            atlas.shelfHeight = 0;
+        }
+        if (atlas.shelfY + height > ATLAS_SIZE) {
+            continue;
+        }
+        
+        atlas.texture->update(image, atlas.shelfX, atlas.shelfY);
+        rect = sf::IntRect(static_cast<int>(atlas.shelfX), static_cast<int>(atlas.shelfY),
+                           static_cast<int>(size.x), static_cast<int>(size.y));
+        texture = atlas.texture.get();
+        
+        atlas.shelfX += width;
+        atlas.shelfHeight = std::max(atlas.shelfHeight, height);
+        return true;
+    }
+    
+    Atlas atlas;
+    atlas.texture = std::make_unique<sf::Texture>();
+    if (!atlas.texture->create(ATLAS_SIZE, ATLAS_SIZE)) {
+        return false;
+    }
+    atlas.texture->setSmooth(true);
+    atlases.push_back(std::move(atlas));
+    
+    return placeInAtlas(image, texture, rect);
+}
+
+void ResourceCache::reportTimings() {
+    double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - firstRequestAt).count();
+    
+    std::cout << "Textures: " << loadedCount << " loaded (" << atlasedCount << " in "
+              << atlases.size() << " atlas pages), " << missingPaths.size() << " missing; "
+              << "wall " << static_cast<int>(wallMs) << " ms, decode " << static_cast<int>(decodeTotalMs)
+              << " ms on " << WORKER_COUNT << " workers, upload " << static_cast<int>(uploadTotalMs)
+              << " ms, slowest " << static_cast<int>(slowestMs) << " ms" << std::endl;
+    
+    if (!missingPaths.empty()) {
+        std::cout << "Missing textures (flat colours used):";
+        for (const auto& path : missingPaths) {
+            std::cout << " " << path;
+        }
+        std::cout << std::endl;
+        missingPaths.clear();
+    }
+}
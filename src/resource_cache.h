@@ -0,0 +1,113 @@
+#ifndef RESOURCE_CACHE_H
+#define RESOURCE_CACHE_H
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+// Shared textures and fonts keyed by path. Images are decoded on worker
+// threads and uploaded on the main thread by pump(); small images go into
+// a shared atlas. A TextureHandle is returned immediately and becomes
+// ready once its upload has happened.
+class ResourceCache {
+public:
+    class TextureHandle {
+    public:
+        bool isReady() const { return slot && slot->state == State::READY; }
+        bool hasFailed() const { return !slot || slot->state == State::FAILED; }
+        const sf::Texture* getTexture() const { return isReady() ? slot->texture : nullptr; }
+        sf::IntRect getRect() const { return slot ? slot->rect : sf::IntRect(); }
+    
+    private:
+        friend class ResourceCache;
+        
+        enum class State {
+            PENDING,
+            READY,
+            FAILED
+        };
+        
+        struct Slot {
+            State state = State::PENDING;
+            const sf::Texture* texture = nullptr;
+            sf::IntRect rect;
+        };
+        
+        std::shared_ptr<Slot> slot;
+    };
+    
+    static ResourceCache& getInstance();
+    
+    TextureHandle loadTexture(const std::string& path);
+    
+    // Loads synchronously; returns the first candidate that loads, or
+    // nullptr when none does.
+    sf::Font* loadFont(const std::vector<std::string>& candidatePaths);
+    
+    // Uploads decoded images; call once per frame from the thread that
+    // owns the GL context. Returns the number of handles that changed.
+    int pump();
+    
+    int getPendingCount() const;
+
+private:
+    ResourceCache();
+    ~ResourceCache();
+    
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+    
+    using Clock = std::chrono::steady_clock;
+    
+    struct Request {
+        std::string path;
+        std::shared_ptr<TextureHandle::Slot> slot;
+        Clock::time_point queuedAt;
+        double decodeMs = 0.0;
+        bool decoded = false;
+        sf::Image image;
+    };
+    
+    struct Atlas {
+        std::unique_ptr<sf::Texture> texture;
+        unsigned int shelfX = 0;
+        unsigned int shelfY = 0;
+        unsigned int shelfHeight = 0;
+    };
+    
+    std::map<std::string, std::shared_ptr<TextureHandle::Slot>> textures;
+    std::map<std::string, std::unique_ptr<sf::Font>> fonts;
+    std::vector<std::unique_ptr<sf::Texture>> standaloneTextures;
+    std::vector<Atlas> atlases;
+    
+    mutable std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<Request> pendingDecode;
+    std::deque<Request> decodedQueue;
+    std::vector<std::thread> workers;
+    bool stopping;
+    int inFlight;
+    
+    int loadedCount;
+    int atlasedCount;
+    std::vector<std::string> missingPaths;
+    double decodeTotalMs;
+    double uploadTotalMs;
+    double slowestMs;
+    Clock::time_point firstRequestAt;
+    bool reported;
+    
+    void workerLoop();
+    void upload(Request& request);
+    bool placeInAtlas(const sf::Image& image, const sf::Texture*& texture, sf::IntRect& rect);
+    void reportTimings();
+};
+
+#endif
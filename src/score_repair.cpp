@@ -0,0 +1,244 @@
+#include "score_repair.h"
+#include "player.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+
+std::vector<ScoreRepair::NameRange> ScoreRepair::splitRanges(const std::vector<std::string>& names, int rangeCount) {
+    std::vector<NameRange> ranges;
+    if (names.empty()) {
+        return ranges;
+    }
+    
+    size_t count = std::max<size_t>(1, std::min<size_t>(rangeCount, names.size()));
+    size_t perRange = (names.size() + count - 1) / count;
+    for (size_t begin = 0; begin < names.size(); begin += perRange) {
+        size_t end = std::min(begin + perRange, names.size()) - 1;
+        ranges.push_back({names[begin], names[end]});
+    }
+    return ranges;
+}
+
+bool ScoreRepair::scanRange(pqxx::connection& connection, const NameRange& range,
+                            std::vector<Fix>& fixes, int& scanned) {
+    try {
+        pqxx::read_transaction txn(connection);
+        
+        auto result = txn.exec_params(
+            "SELECT p.name, p.total_score, p.quizzes_completed, "
+            "COALESCE(q.score, 0) + COALESCE(s.score, 0) AS quiz_score, "
+            "COALESCE(q.quizzes, 0) + COALESCE(s.quizzes, 0) AS quiz_count, "
+            "COALESCE(a.ids, '') AS achievement_ids "
+            "FROM players p "
+            "LEFT JOIN (SELECT name, SUM(score) AS score, COUNT(*) AS quizzes FROM quiz_results "
+            "           WHERE name BETWEEN $1 AND $2 GROUP BY name) q ON q.name = p.name "
+            "LEFT JOIN (SELECT name, SUM(total_score) AS score, SUM(quizzes_archived) AS quizzes "
+            "           FROM quiz_result_summaries WHERE name BETWEEN $1 AND $2 GROUP BY name) s ON s.name = p.name "
+            "LEFT JOIN (SELECT name, string_agg(achievement_id, ',') AS ids FROM achievements "
+            "           WHERE name BETWEEN $1 AND $2 GROUP BY name) a ON a.name = p.name "
+            "WHERE p.name BETWEEN $1 AND $2",
+            range.first, range.last
+        );
+        
+        const auto& definitions = Player::achievementDefinitions();
+        for (const auto& row : result) {
+            int rewardPoints = 0;
+            std::stringstream ids(row["achievement_ids"].as<std::string>());
+            std::string id;
+            while (std::getline(ids, id, ',')) {
+                auto it = definitions.find(id);
+                if (it != definitions.end()) {
+                    rewardPoints += it->second.rewardPoints;
+                }
+            }
+            
+            Fix fix;
+            fix.name = row["name"].as<std::string>();
+            fix.storedScore = row["total_score"].is_null() ? 0 : row["total_score"].as<int>();
+            fix.storedQuizzes = row["quizzes_completed"].is_null() ? 0 : row["quizzes_completed"].as<int>();
+            fix.expectedQuizzes = row["quiz_count"].as<int>();
+            // Study points are only kept in the player's save file, so the
+            // server-side sum is a lower bound: raise the score to it, never
+            // lower it.
+            fix.expectedScore = std::max(fix.storedScore, row["quiz_score"].as<int>() + rewardPoints);
+            
+            if (fix.storedScore != fix.expectedScore || fix.storedQuizzes != fix.expectedQuizzes) {
+                fixes.push_back(fix);
+            }
+            scanned++;
+        }
+        return true;
+    
+    } catch (const std::exception& e) {
+        std::cerr << "Score repair failed to scan names " << range.first << " .. " << range.last
+                  << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+int ScoreRepair::applyBatch(pqxx::connection& connection, const std::vector<Fix>& batch) {
+    try {
+        pqxx::work txn(connection);
+        
+        std::stringstream values;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const Fix& fix = batch[i];
+            values << (i == 0 ? "" : ", ") << "(" << txn.quote(fix.name) << ", "
+                   << fix.storedScore << ", " << fix.storedQuizzes << ", "
+                   << fix.expectedScore << ", " << fix.expectedQuizzes << ")";
+        }
+        
+        auto result = txn.exec(
+            "UPDATE players AS p SET "
+            "total_score = v.expected_score, "
+            "quizzes_completed = v.expected_quizzes, "
+            "version = p.version + 1 "
+            "FROM (VALUES " + values.str() + ") "
+            "AS v(name, stored_score, stored_quizzes, expected_score, expected_quizzes) "
+            "WHERE p.name = v.name "
+            "AND COALESCE(p.total_score, 0) = v.stored_score "
+            "AND COALESCE(p.quizzes_completed, 0) = v.stored_quizzes"
+        );
+        
+        txn.commit();
+        return static_cast<int>(result.affected_rows());
+    
+    } catch (const std::exception& e) {
+        std::cerr << "Score repair failed to apply a batch of " << batch.size()
+                  << " fixes: " << e.what() << std::endl;
+        return -1;
+    }
+}
+
+ScoreRepair::Report ScoreRepair::run(const Options& options) {
+    Report report;
+    auto startTime = std::chrono::steady_clock::now();
+    
+    std::vector<std::string> names;
+    try {
+        pqxx::connection connection(options.connString);
+        pqxx::read_transaction txn(connection);
+        
+        for (const auto& row : txn.exec("SELECT name FROM players ORDER BY name")) {
+            names.push_back(row["name"].as<std::string>());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Score repair cannot list players: " << e.what() << std::endl;
+        report.failedRanges = 1;
+        return report;
+    }
+    
+    int threadCount = std::max(1, options.threads);
+    std::vector<NameRange> ranges = splitRanges(names, threadCount * std::max(1, options.rangesPerThread));
+    
+    std::cout << "Score repair: " << names.size() << " players in " << ranges.size()
+              << " ranges on " << threadCount << " threads"
+              << (options.apply ? "" : " (dry run)") << std::endl;
+    
+    std::atomic<size_t> nextRange{0};
+    std::atomic<int> scanned{0};
+    std::atomic<int> drifted{0};
+    std::atomic<int> fixed{0};
+    std::atomic<int> conflicts{0};
+    std::atomic<int> batches{0};
+    std::atomic<int> failedRanges{0};
+    std::atomic<int> workersLeft{threadCount};
+    std::mutex logMutex;
+    
+    auto worker = [&]() {
+        std::unique_ptr<pqxx::connection> connection;
+        try {
+            connection = std::make_unique<pqxx::connection>(options.connString);
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(logMutex);
+            std::cerr << "Score repair worker cannot connect: " << e.what() << std::endl;
+            workersLeft--;
+            return;
+        }
+        
+        while (true) {
+            size_t index = nextRange++;
+            if (index >= ranges.size()) {
+                break;
+            }
+            
+            std::vector<Fix> fixes;
+            int rangeScanned = 0;
+            if (!scanRange(*connection, ranges[index], fixes, rangeScanned)) {
+                failedRanges++;
+                continue;
+            }
+            scanned += rangeScanned;
+            drifted += static_cast<int>(fixes.size());
+            
+            for (const auto& fix : fixes) {
+                std::lock_guard<std::mutex> lock(logMutex);
+                std::cout << "  " << fix.name << ": score " << fix.storedScore << " -> " << fix.expectedScore
+                          << ", quizzes " << fix.storedQuizzes << " -> " << fix.expectedQuizzes << std::endl;
+            }
+            
+            if (!options.apply) {
+                continue;
+            }
+            
+            size_t batchSize = static_cast<size_t>(std::max(1, options.batchSize));
+            for (size_t begin = 0; begin < fixes.size(); begin += batchSize) {
+                std::vector<Fix> batch(fixes.begin() + begin,
+                                       fixes.begin() + std::min(begin + batchSize, fixes.size()));
+                int applied = applyBatch(*connection, batch);
+                if (applied < 0) {
+                    failedRanges++;
+                    break;
+                }
+                fixed += applied;
+                conflicts += static_cast<int>(batch.size()) - applied;
+                batches++;
+            }
+        }
+        workersLeft--;
+    };
+    
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threadCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    
+    while (workersLeft > 0) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        std::lock_guard<std::mutex> lock(logMutex);
+        std::cout << "Score repair progress: " << scanned << "/" << names.size() << " players, "
+                  << std::fixed << std::setprecision(1) << (elapsed > 0.0 ? scanned / elapsed : 0.0)
+                  << " players/s, " << drifted << " drifted, " << fixed << " fixed" << std::endl;
+    }
+    
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    
+    // Ranges nobody picked up, e.g. because no worker could connect.
+    size_t claimed = std::min(nextRange.load(), ranges.size());
+    failedRanges += static_cast<int>(ranges.size() - claimed);
+    
+    report.playersScanned = scanned;
+    report.playersDrifted = drifted;
+    report.playersFixed = fixed;
+    report.conflicts = conflicts;
+    report.batches = batches;
+    report.failedRanges = failedRanges;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    
+    std::cout << "Score repair finished in " << std::fixed << std::setprecision(2) << report.seconds << " s: "
+              << report.playersScanned << " scanned, " << report.playersDrifted << " drifted, "
+              << report.playersFixed << " fixed in " << report.batches << " batches, "
+              << report.conflicts << " changed concurrently, " << report.failedRanges << " failures" << std::endl;
+    
+    return report;
+}
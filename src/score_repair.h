@@ -0,0 +1,57 @@
+#ifndef SCORE_REPAIR_H
+#define SCORE_REPAIR_H
+
+#include <pqxx/pqxx>
+#include <string>
+#include <vector>
+
+// Rebuilds players.quizzes_completed from quiz_results and
+// quiz_result_summaries (archived terms), and raises players.total_score
+// to at least the quiz and achievement points found there. The score is
+// never lowered: study points are awarded locally and not recorded on the
+// server.
+// Work is split into contiguous name ranges handled by worker threads,
+// each on its own connection; fixes are written in batched UPDATEs that
+// only apply if the stored values have not changed since they were read.
+class ScoreRepair {
+public:
+    struct Options {
+        std::string connString = "dbname=astrolearn user=postgres password=postgres host=localhost port=5432";
+        int threads = 4;
+        int rangesPerThread = 4;
+        int batchSize = 200;
+        bool apply = false;
+    };
+    
+    struct Report {
+        int playersScanned = 0;
+        int playersDrifted = 0;
+        int playersFixed = 0;
+        int conflicts = 0;
+        int batches = 0;
+        int failedRanges = 0;
+        double seconds = 0.0;
+    };
+    
+    static Report run(const Options& options);
+
+private:
+    struct NameRange {
+        std::string first;
+        std::string last;
+    };
+    
+    struct Fix {
+        std::string name;
+        int storedScore;
+        int storedQuizzes;
+        int expectedScore;
+        int expectedQuizzes;
+    };
+    
+    static std::vector<NameRange> splitRanges(const std::vector<std::string>& names, int rangeCount);
+    static bool scanRange(pqxx::connection& connection, const NameRange& range, std::vector<Fix>& fixes, int& scanned);
+    static int applyBatch(pqxx::connection& connection, const std::vector<Fix>& batch);
+};
+
+#endif
@@ -1,13 +1,79 @@
 #include "solar_system.h"
+#include "ui_layout.h"
 #include <iostream>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
+#include <SFML/OpenGL.hpp>
+
+namespace {
+
+bool circleIntersects(const sf::FloatRect& rect, const sf::Vector2f& position, float radius) {
+    float nearestX = std::max(rect.left, std::min(position.x, rect.left + rect.width));
+    float nearestY = std::max(rect.top, std::min(position.y, rect.top + rect.height));
+    float dx = position.x - nearestX;
+    float dy = position.y - nearestY;
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+}
+
+// Every orbit as line segments in one buffer, innermost first, so the
+// visible orbits are a contiguous range of it.
+struct SolarSystem::OrbitBatch {
+    std::shared_ptr<sf::VertexBuffer> buffer;
+    // Used when vertex buffers are unavailable.
+    std::vector<sf::Vertex> vertices;
+    std::vector<float> radii;
+    // Vertex offsets, one per orbit plus the end.
+    std::vector<size_t> offsets;
+};
+
+namespace {
+
+// Draws orbits first..last of a batch in one call.
+class OrbitRange : public sf::Drawable {
+public:
+    OrbitRange(std::shared_ptr<const SolarSystem::OrbitBatch> batch, size_t first, size_t last)
+        : batch(std::move(batch)), first(first), last(last) {
+    }
+    
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        size_t begin = batch->offsets[first];
+        size_t count = batch->offsets[last + 1] - begin;
+        if (batch->buffer) {
+            target.draw(*batch->buffer, begin, count, states);
+        } else {
+            target.draw(&batch->vertices[begin], count, sf::Lines, states);
+        }
+    }
+    
+    std::shared_ptr<const SolarSystem::OrbitBatch> batch;
+    size_t first;
+    size_t last;
+};
+
+// Zoom bands of half an octave; orbits are tessellated for the top of the
+// band, so the chord error bound holds across all of it.
+int zoomBand(float zoom) {
+    return static_cast<int>(std::floor(std::log2(zoom) * 2.0f));
+}
+
+float bandZoom(int band) {
+    return std::exp2((band + 1) * 0.5f);
+}
+
+}
 
 SolarSystem::SolarSystem()
     : currentMode(DisplayMode::ORRERY)
-    , scale(1.0f)
-    , center(512.0f, 384.0f)
-    , selectedBody(nullptr) {
+    , selectedBody(nullptr)
+    , labelFont(nullptr)
+    , stepAccumulator(0.0f)
+    , interpolation(1.0f)
+    , orbitBand(0)
+    , orbitsDirty(true) {
 }
 
 void SolarSystem::init() {
@@ -107,26 +173,239 @@ void SolarSystem::createSolarSystem() {
         "resources/textures/pluto.png"
     ));
     
+    for (auto& body : bodies) {
+        body->setLabelFont(labelFont);
+    }
+    orbitsDirty = true;
+    labelPlacer.reset();
+    
     std::cout << "Created solar system with " << bodies.size() << " bodies" << std::endl;
 }
 
 void SolarSystem::update(float deltaTime) {
+    stepAccumulator += deltaTime;
+    
+    int steps = 0;
+    while (stepAccumulator >= FIXED_STEP && steps < MAX_STEPS_PER_UPDATE) {
+        for (auto& body : bodies) {
+            body->update(FIXED_STEP);
+        }
+        stepAccumulator -= FIXED_STEP;
+        steps++;
+    }
+    
+    if (stepAccumulator >= FIXED_STEP) {
+        std::cerr << "Simulation fell behind, dropping " << stepAccumulator << " s" << std::endl;
+        stepAccumulator = std::fmod(stepAccumulator, FIXED_STEP);
+    }
+    
+    interpolation = stepAccumulator / FIXED_STEP;
+}
+
+void SolarSystem::placeBodies() {
     for (auto& body : bodies) {
-        body->update(deltaTime);
+        body->place(interpolation);
+    }
+}
+
+void SolarSystem::draw(DrawList& frame, const Camera& camera) {
+    int band = zoomBand(camera.getZoom());
+    if (orbitsDirty || band != orbitBand) {
+        rebuildOrbits(band);
+    }
+    
+    const sf::FloatRect visibleRect = camera.getVisibleRect();
+    const float pixelsPerUnit = camera.getZoom();
+    
+    // Visible orbits are those between the view's nearest and farthest
+    // points from the origin and large enough to see, so a run of radii.
+    size_t firstOrbit = orbits->radii.size();
+    size_t lastOrbit = 0;
+    for (size_t k = 0; k < orbits->radii.size(); ++k) {
+        if (orbitVisible(orbits->radii[k], camera)) {
+            firstOrbit = std::min(firstOrbit, k);
+            lastOrbit = k;
+        }
+    }
+    if (firstOrbit <= lastOrbit) {
+        // Published frames share the range object, so only a new range
+        // makes a new one.
+        if (!orbitRange || firstOrbit != orbitRangeFirst || lastOrbit != orbitRangeLast) {
+            orbitRange = std::make_shared<OrbitRange>(orbits, firstOrbit, lastOrbit);
+            orbitRangeFirst = firstOrbit;
+            orbitRangeLast = lastOrbit;
+        }
+        frame.drawShared(orbitRange);
+    }
+    
+    bodyDetail.assign(bodies.size(), Detail::CULLED);
+    std::shared_ptr<sf::VertexArray> points;
+    
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        CelestialBody& body = *bodies[i];
+        if (!circleIntersects(visibleRect, body.getDisplayPosition(), body.getBoundingRadius())) {
+            continue;
+        }
+        
+        if (body.getBoundingRadius() * pixelsPerUnit <= POINT_MAX_PIXELS) {
+            if (!points) {
+                points = std::make_shared<sf::VertexArray>(sf::Points);
+            }
+            points->append(sf::Vertex(body.getDisplayPosition(), body.getColor()));
+            bodyDetail[i] = Detail::POINT;
+        } else {
+            body.draw(frame, 1.0f / pixelsPerUnit);
+            bodyDetail[i] = Detail::FULL;
+        }
+    }
+    
+    if (points) {
+        frame.drawShared(points);
+    }
+}
+
+void SolarSystem::drawLabels(DrawList& frame, const Camera& camera) {
+    const float pixelsPerUnit = camera.getZoom();
+    
+    // Labels sit next to the body and are roughly this far across.
+    const float labelMargin = 80.0f;
+    const sf::FloatRect labelRect(-labelMargin, -labelMargin,
+                                  UILayout::SCREEN_WIDTH + 2 * labelMargin, UILayout::SCREEN_HEIGHT + 2 * labelMargin);
+    
+    labelCandidates.clear();
+    for (size_t i = 0; i < bodies.size() && i < bodyDetail.size(); ++i) {
+        CelestialBody& body = *bodies[i];
+        bool selected = body.getSelected();
+        if (bodyDetail[i] == Detail::CULLED && !selected) {
+            continue;
+        }
+        
+        float pixelRadius = body.getDisplayRadius() * pixelsPerUnit;
+        if (pixelRadius < LABEL_MIN_PIXELS && !selected) {
+            continue;
+        }
+        
+        sf::Vector2f position = camera.worldToScreen(body.getDisplayPosition());
+        if (!labelRect.contains(position)) {
+            continue;
+        }
+        
+        sf::Vector2f size = body.getLabelSize();
+        if (size.x > 0) {
+            labelCandidates.push_back({position, pixelRadius, size,
+                                       labelPriority(body, pixelRadius), static_cast<uint32_t>(i)});
+        }
+    }
+    
+    const std::vector<uint8_t>& anchors = labelPlacer.place(labelCandidates, labelRect);
+    for (size_t k = 0; k < labelCandidates.size(); ++k) {
+        if (anchors[k] != LabelPlacer::HIDDEN) {
+            const LabelPlacer::Candidate& candidate = labelCandidates[k];
+            bodies[candidate.key]->drawLabel(frame,
+                LabelPlacer::labelCenter(candidate, static_cast<LabelPlacer::Anchor>(anchors[k])));
+        }
     }
 }
 
-void SolarSystem::draw(sf::RenderWindow& window) {
+uint16_t SolarSystem::labelPriority(const CelestialBody& body, float pixelRadius) {
+    if (body.getSelected()) {
+        return 0xffff;
+    }
+    
+    uint16_t rank = 0;
+    switch (body.getType()) {
+        case CelestialBody::Type::STAR: rank = 4; break;
+        case CelestialBody::Type::PLANET: rank = 3; break;
+        case CelestialBody::Type::DWARF_PLANET: rank = 2; break;
+        default: rank = 1; break;
+    }
+    return static_cast<uint16_t>(rank * 1000 + std::min(999.0f, pixelRadius));
+}
+
+bool SolarSystem::orbitVisible(float orbit, const Camera& camera) {
+    if (orbit * camera.getZoom() < ORBIT_MIN_PIXELS) {
+        return false;
+    }
+    
+    // The circle crosses the rect unless the rect lies entirely inside or
+    // entirely outside it. Orbits are centred on the origin.
+    const sf::FloatRect rect = camera.getVisibleRect();
+    float farX = std::max(std::abs(rect.left), std::abs(rect.left + rect.width));
+    float farY = std::max(std::abs(rect.top), std::abs(rect.top + rect.height));
+    if (farX * farX + farY * farY < orbit * orbit) {
+        return false;
+    }
+    return circleIntersects(rect, sf::Vector2f(0.0f, 0.0f), orbit);
+}
+
+void SolarSystem::rebuildOrbits(int band) {
+    const float pi = 3.14159265f;
+    const sf::Color orbitColor(100, 100, 100, 100);
+    const float pixelsPerUnit = bandZoom(band);
+    
+    auto batch = std::make_shared<OrbitBatch>();
+    for (const auto& body : bodies) {
+        if (body->getOrbitRadius() > 0) {
+            batch->radii.push_back(body->getOrbitRadius());
+        }
+    }
+    std::sort(batch->radii.begin(), batch->radii.end());
+    
+    std::vector<sf::Vertex> vertices;
+    batch->offsets.push_back(0);
+    for (float orbit : batch->radii) {
+        // A chord of n segments strays r * (1 - cos(pi / n)) from the
+        // circle, about r * pi^2 / (2 n^2).
+        float pixelRadius = orbit * pixelsPerUnit;
+        int segments = static_cast<int>(std::ceil(pi * std::sqrt(pixelRadius / (2.0f * ORBIT_MAX_ERROR_PIXELS))));
+        segments = std::max(32, std::min(segments, 4096));
+        
+        sf::Vector2f previous(orbit, 0.0f);
+        for (int i = 1; i <= segments; ++i) {
+            float angle = 2.0f * pi * i / segments;
+            sf::Vector2f next(orbit * std::cos(angle), orbit * std::sin(angle));
+            vertices.emplace_back(previous, orbitColor);
+            vertices.emplace_back(next, orbitColor);
+            previous = next;
+        }
+        batch->offsets.push_back(vertices.size());
+    }
+    
+    // Published frames may still hold the old buffer, so build a new one.
+    // The render thread owns the window's context, so upload through one
+    // of our own.
+    if (sf::VertexBuffer::isAvailable() && !vertices.empty()) {
+        sf::Context context;
+        auto buffer = std::make_shared<sf::VertexBuffer>(sf::Lines, sf::VertexBuffer::Static);
+        if (buffer->create(vertices.size()) && buffer->update(vertices.data())) {
+            batch->buffer = buffer;
+        }
+        // Make the upload visible to the render thread's context before
+        // it draws it.
+        glFlush();
+    }
+    if (!batch->buffer) {
+        batch->vertices.swap(vertices);
+    }
+    
+    orbits = batch;
+    orbitRange.reset();
+    orbitBand = band;
+    orbitsDirty = false;
+}
+
+void SolarSystem::setLabelFont(const sf::Font& font) {
+    labelFont = &font;
     for (auto& body : bodies) {
-        body->draw(window, center.x, center.y);
+        body->setLabelFont(labelFont);
     }
 }
 
-void SolarSystem::selectBodyAt(float x, float y) {
+void SolarSystem::selectBodyAt(const sf::Vector2f& world, float minRadius) {
     clearSelection();
     
     for (auto it = bodies.rbegin(); it != bodies.rend(); ++it) {
-        if ((*it)->contains(x, y, center.x, center.y)) {
+        if ((*it)->contains(world.x, world.y, minRadius)) {
             (*it)->setSelected(true);
             selectedBody = it->get();
             std::cout << "Selected: " << selectedBody->getName() << std::endl;
@@ -168,47 +447,18 @@ void SolarSystem::setDisplayMode(DisplayMode mode) {
     if (currentMode != mode) {
         currentMode = mode;
         
-        switch (mode) {
-            case DisplayMode::REAL_SCALE:
-                scale = 0.0001f;
-                break;
-            case DisplayMode::ORRERY:
-                scale = 1.0f;
-                break;
-            case DisplayMode::ZOOMED:
-                scale = 2.0f;
-                break;
-        }
-        
         std::cout << "Display mode set to: ";
         switch (mode) {
             case DisplayMode::REAL_SCALE: std::cout << "Real scale"; break;
             case DisplayMode::ORRERY: std::cout << "Orrery"; break;
             case DisplayMode::ZOOMED: std::cout << "Zoomed"; break;
         }
-        std::cout << " (scale: " << scale << "x)" << std::endl;
+        std::cout << std::endl;
     }
 }
 
-void SolarSystem::setScale(float newScale) {
-    scale = newScale;
-    if (scale < 0.1f) scale = 0.1f;
-    if (scale > 5.0f) scale = 5.0f;
-}
-
-void SolarSystem::setCenter(float x, float y) {
-    center.x = x;
-    center.y = y;
-}
-
 void SolarSystem::addBody(std::unique_ptr<CelestialBody> body) {
+    body->setLabelFont(labelFont);
     bodies.push_back(std::move(body));
-}
-
-float SolarSystem::calculateDisplayRadius(float realRadius) const {
-    return realRadius * scale;
-}
-
-float SolarSystem::calculateDisplayOrbit(float realOrbit) const {
-    return realOrbit * scale;
+    orbitsDirty = true;
 }
@@ -6,6 +6,8 @@
 #include <memory>
 #include <string>
 #include "celestial_body.h"
+#include "label_placer.h"
+#include "camera.h"
 
 class SolarSystem {
 public:
@@ -13,11 +15,40 @@ public:
     
     void init();
     
+    // Advances by deltaTime simulated seconds in fixed steps; the remainder
+    // is carried over and used to interpolate the drawn positions.
     void update(float deltaTime);
     
-    void draw(sf::RenderWindow& window);
+    static constexpr float FIXED_STEP = 1.0f / 120.0f;
+    static constexpr int MAX_STEPS_PER_UPDATE = 2048;
     
-    void selectBodyAt(float x, float y);
+    // Moves the bodies to their interpolated positions for this frame.
+    void placeBodies();
+    
+    // Draws in world coordinates through the camera's view, culled against
+    // what it sees. Orbits share one static buffer of line segments,
+    // tessellated for the current zoom band to within ORBIT_MAX_ERROR_PIXELS
+    // and rebuilt when the zoom leaves the band; the visible ones go out in
+    // a single draw call. Bodies smaller than a pixel are batched into
+    // points, and labels of bodies below LABEL_MIN_PIXELS are hidden unless
+    // the body is selected. The remaining labels are decluttered in screen
+    // space, the selected body's first, then stars, planets and dwarf
+    // planets, larger bodies before smaller ones.
+    void draw(DrawList& frame, const Camera& camera);
+    void drawLabels(DrawList& frame, const Camera& camera);
+    
+    static constexpr float POINT_MAX_PIXELS = 1.0f;
+    static constexpr float LABEL_MIN_PIXELS = 3.0f;
+    static constexpr float ORBIT_MIN_PIXELS = 2.0f;
+    static constexpr float ORBIT_MAX_ERROR_PIXELS = 0.25f;
+    
+    // Defined in solar_system.cpp.
+    struct OrbitBatch;
+    
+    void setLabelFont(const sf::Font& font);
+    
+    // World coordinates; minRadius keeps tiny bodies clickable.
+    void selectBodyAt(const sf::Vector2f& world, float minRadius);
     void clearSelection();
     CelestialBody* getSelectedBody() const;
     
@@ -33,24 +64,40 @@ public:
     void setDisplayMode(DisplayMode mode);
     DisplayMode getDisplayMode() const { return currentMode; }
     
-    void setScale(float scale);
-    float getScale() const { return scale; }
-    
-    void setCenter(float x, float y);
-    sf::Vector2f getCenter() const { return center; }
-    
 private:
     std::vector<std::unique_ptr<CelestialBody>> bodies;
     DisplayMode currentMode;
-    float scale;
-    sf::Vector2f center;
     CelestialBody* selectedBody;
+    const sf::Font* labelFont;
+    
+    float stepAccumulator;
+    float interpolation;
+    
+    enum class Detail : uint8_t {
+        CULLED,
+        POINT,
+        FULL
+    };
+    
+    // Parallel to bodies; filled by draw() and read by drawLabels().
+    std::vector<Detail> bodyDetail;
+    LabelPlacer labelPlacer;
+    std::vector<LabelPlacer::Candidate> labelCandidates;
+    
+    std::shared_ptr<const OrbitBatch> orbits;
+    // The range drawn last frame, kept while it stays the same.
+    std::shared_ptr<const sf::Drawable> orbitRange;
+    size_t orbitRangeFirst = 0;
+    size_t orbitRangeLast = 0;
+    int orbitBand;
+    bool orbitsDirty;
     
     void createSolarSystem();
+    void rebuildOrbits(int band);
     void addBody(std::unique_ptr<CelestialBody> body);
     
-    float calculateDisplayRadius(float realRadius) const;
-    float calculateDisplayOrbit(float realOrbit) const;
+    static bool orbitVisible(float orbit, const Camera& camera);
+    static uint16_t labelPriority(const CelestialBody& body, float pixelRadius);
 };
 
 #endif
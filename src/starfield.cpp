@@ -0,0 +1,99 @@
+#include "starfield.h"
+#include <iostream>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+Starfield::Starfield()
+    : tileSize(2048.0f)
+    , starCount(0)
+    , useVertexBuffer(sf::VertexBuffer::isAvailable()) {
+}
+
+void Starfield::generate(unsigned int seed, int starCount, int layerCount, float tileSize) {
+    this->tileSize = tileSize;
+    this->starCount = starCount;
+    layers.clear();
+    layers.resize(std::max(1, layerCount));
+    
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(0.0f, tileSize);
+    std::uniform_int_distribution<int> tint(-20, 20);
+    
+    for (size_t i = 0; i < layers.size(); ++i) {
+        Layer& layer = layers[i];
+        float nearness = layers.size() > 1 ? static_cast<float>(i) / (layers.size() - 1) : 1.0f;
+        layer.depth = 0.05f + 0.45f * nearness;
+        
+        // Far layers hold most of the stars, as in the real sky.
+        int layerStars = static_cast<int>(starCount * std::pow(0.5f, static_cast<float>(i + 1)));
+        if (i + 1 == layers.size()) {
+            int assigned = 0;
+            for (size_t j = 0; j + 1 < layers.size(); ++j) {
+                assigned += static_cast<int>(starCount * std::pow(0.5f, static_cast<float>(j + 1)));
+            }
+            layerStars = starCount - assigned;
+        }
+        
+        int minBrightness = static_cast<int>(70 + 120 * nearness);
+        std::uniform_int_distribution<int> brightness(minBrightness, std::min(255, minBrightness + 65));
+        
+        std::vector<sf::Vertex> vertices(layerStars);
+        for (auto& vertex : vertices) {
+            int value = brightness(rng);
+            int shift = tint(rng);
+            vertex.position = sf::Vector2f(position(rng), position(rng));
+            vertex.color = sf::Color(static_cast<sf::Uint8>(std::max(0, std::min(255, value + shift))),
+                                     static_cast<sf::Uint8>(value),
+                                     static_cast<sf::Uint8>(std::max(0, std::min(255, value - shift))));
+        }
+        
+        if (useVertexBuffer) {
+            layer.buffer.setPrimitiveType(sf::Points);
+            layer.buffer.setUsage(sf::VertexBuffer::Static);
+            if (layer.buffer.create(vertices.size()) && layer.buffer.update(vertices.data())) {
+                continue;
+            }
+            std::cerr << "Vertex buffers unavailable, starfield falls back to vertex arrays" << std::endl;
+            useVertexBuffer = false;
+        }
+        
+        layer.fallback.setPrimitiveType(sf::Points);
+        for (const auto& vertex : vertices) {
+            layer.fallback.append(vertex);
+        }
+    }
+    
+    std::cout << "Starfield generated: " << starCount << " stars in " << layers.size() << " layers" << std::endl;
+}
+
+void Starfield::draw(DrawList& frame, const sf::Vector2f& cameraOffset, float zoom) const {
+    sf::Vector2f viewSize = frame.getView().getSize();
+    sf::Vector2f viewCenter = frame.getView().getCenter();
+    sf::Vector2f viewOrigin = viewCenter - viewSize / 2.0f;
+    
+    for (const auto& layer : layers) {
+        float layerZoom = std::max(0.5f, 1.0f + (zoom - 1.0f) * layer.depth);
+        float span = tileSize * layerZoom;
+        
+        float shiftX = std::fmod(cameraOffset.x * layer.depth * layerZoom, span);
+        float shiftY = std::fmod(cameraOffset.y * layer.depth * layerZoom, span);
+        if (shiftX < 0) shiftX += span;
+        if (shiftY < 0) shiftY += span;
+        
+        // The tile is at least as large as the view, so four copies cover it.
+        for (int ty = 0; ty < 2; ++ty) {
+            for (int tx = 0; tx < 2; ++tx) {
+                sf::Transform transform;
+                transform.translate(viewOrigin.x - shiftX + tx * span, viewOrigin.y - shiftY + ty * span);
+                transform.scale(layerZoom, layerZoom);
+                
+                if (useVertexBuffer) {
+                    frame.drawStatic(layer.buffer, sf::RenderStates(transform));
+                } else {
+                    frame.drawStatic(layer.fallback, sf::RenderStates(transform));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef STARFIELD_H
+#define STARFIELD_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "draw_list.h"
+
+// Procedural background stars split into depth layers. Each layer is a
+// square tile of points uploaded once to the GPU and drawn wrapped around
+// the view, so a frame costs a fixed number of draw calls and only the
+// per-layer transforms are computed on the CPU.
+class Starfield {
+public:
+    Starfield();
+    
+    void generate(unsigned int seed, int starCount = 60000, int layerCount = 4, float tileSize = 2048.0f);
+    
+    // cameraOffset is the world point the camera looks at relative to its
+    // rest position; zoom is the camera scale (1 = rest). Far layers move
+    // and scale less than near ones.
+    void draw(DrawList& frame, const sf::Vector2f& cameraOffset, float zoom) const;
+    
+    int getStarCount() const { return starCount; }
+    int getDrawCallCount() const { return static_cast<int>(layers.size()) * 4; }
+
+private:
+    struct Layer {
+        float depth;
+        sf::VertexBuffer buffer;
+        sf::VertexArray fallback;
+    };
+    
+    std::vector<Layer> layers;
+    float tileSize;
+    int starCount;
+    bool useVertexBuffer;
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include "text_layout.h"
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace {
+
+struct Line {
+    size_t begin;
+    size_t end;
+    float width;
+};
+
+void addGlyphQuad(sf::VertexArray& vertices, float x, float y, const sf::Glyph& glyph, const sf::Color& color) {
+    // Same padding as sf::Text, so neighbouring glyphs in the page do not bleed in.
+    const float padding = 1.0f;
+    
+    float left = glyph.bounds.left - padding;
+    float top = glyph.bounds.top - padding;
+    float right = glyph.bounds.left + glyph.bounds.width + padding;
+    float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+    
+    float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+    float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+    float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+    float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+    
+    vertices.append(sf::Vertex(sf::Vector2f(x + left, y + top), color, sf::Vector2f(u1, v1)));
+    vertices.append(sf::Vertex(sf::Vector2f(x + right, y + top), color, sf::Vector2f(u2, v1)));
+    vertices.append(sf::Vertex(sf::Vector2f(x + left, y + bottom), color, sf::Vector2f(u1, v2)));
+    vertices.append(sf::Vertex(sf::Vector2f(x + left, y + bottom), color, sf::Vector2f(u1, v2)));
+    vertices.append(sf::Vertex(sf::Vector2f(x + right, y + top), color, sf::Vector2f(u2, v1)));
+    vertices.append(sf::Vertex(sf::Vector2f(x + right, y + bottom), color, sf::Vector2f(u2, v2)));
+}
+
+}
+
+void TextLayout::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (!geometry || !geometry->font) {
+        return;
+    }
+    
+    states.transform *= getTransform();
+    states.texture = &geometry->font->getTexture(geometry->characterSize);
+    target.draw(geometry->vertices, states);
+}
+
+size_t TextLayoutCache::KeyHash::operator()(const Key& key) const {
+    size_t hash = std::hash<std::uint64_t>()(key.id);
+    hash = hash * 31 + key.characterSize;
+    hash = hash * 31 + std::hash<float>()(key.maxWidth);
+    hash = hash * 31 + key.color;
+    return hash * 2 + (key.centered ? 1 : 0);
+}
+
+void TextLayoutCache::setFont(const sf::Font* font) {
+    if (this->font != font) {
+        this->font = font;
+        entries.clear();
+    }
+}
+
+TextLayout TextLayoutCache::get(std::uint64_t id, const std::wstring& text, const Style& style,
+                                const std::wstring& prefix) {
+    Key key{id, style.characterSize, style.maxWidth, style.color.toInteger(), style.centered};
+    
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        if (entries.size() >= MAX_ENTRIES) {
+            entries.clear();
+        }
+        it = entries.emplace(key, build(sf::String(prefix + text), style)).first;
+    }
+    return TextLayout(it->second);
+}
+
+std::shared_ptr<const TextLayout::Geometry> TextLayoutCache::build(const sf::String& text, const Style& style) const {
+    auto geometry = std::make_shared<TextLayout::Geometry>();
+    geometry->vertices.setPrimitiveType(sf::Triangles);
+    geometry->font = font;
+    geometry->characterSize = style.characterSize;
+    
+    if (!font || text.isEmpty()) {
+        return geometry;
+    }
+    
+    const unsigned int size = style.characterSize;
+    auto advance = [&](sf::Uint32 previous, sf::Uint32 current) {
+        return font->getKerning(previous, current, size) + font->getGlyph(current, size, false).advance;
+    };
+    
+    // Greedy word wrap: break at the last space that fits, or mid-word if
+    // a single word is wider than the block.
+    std::vector<Line> lines;
+    size_t lineBegin = 0;
+    size_t lastSpace = std::string::npos;
+    float widthAtSpace = 0.0f;
+    float x = 0.0f;
+    sf::Uint32 previous = 0;
+    
+    for (size_t i = 0; i < text.getSize(); ++i) {
+        sf::Uint32 c = text[i];
+        if (c == '\n') {
+            lines.push_back({lineBegin, i, x});
+            lineBegin = i + 1;
+            lastSpace = std::string::npos;
+            x = 0.0f;
+            previous = 0;
+            continue;
+        }
+        
+        float step = advance(previous, c);
+        if (style.maxWidth > 0.0f && c != ' ' && i > lineBegin && x + step > style.maxWidth) {
+            if (lastSpace != std::string::npos) {
+                lines.push_back({lineBegin, lastSpace, widthAtSpace});
+                lineBegin = lastSpace + 1;
+            } else {
+                lines.push_back({lineBegin, i, x});
+                lineBegin = i;
+            }
+            lastSpace = std::string::npos;
+            
+            x = 0.0f;
+            previous = 0;
+            for (size_t j = lineBegin; j < i; ++j) {
+                x += advance(previous, text[j]);
+                previous = text[j];
+            }
+            step = advance(previous, c);
+        }
+        
+        if (c == ' ') {
+            lastSpace = i;
+            widthAtSpace = x;
+        }
+        x += step;
+        previous = c;
+    }
+    lines.push_back({lineBegin, text.getSize(), x});
+    
+    float blockWidth = 0.0f;
+    for (const auto& line : lines) {
+        blockWidth = std::max(blockWidth, line.width);
+    }
+    
+    float lineHeight = font->getLineSpacing(size) * style.lineSpacing;
+    float y = static_cast<float>(size);
+    for (const auto& line : lines) {
+        x = style.centered ? (blockWidth - line.width) / 2.0f : 0.0f;
+        previous = 0;
+        for (size_t i = line.begin; i < line.end; ++i) {
+            sf::Uint32 c = text[i];
+            x += font->getKerning(previous, c, size);
+            previous = c;
+            
+            const sf::Glyph& glyph = font->getGlyph(c, size, false);
+            if (c != ' ' && c != '\t') {
+                addGlyphQuad(geometry->vertices, x, y, glyph, style.color);
+            }
+            x += glyph.advance;
+        }
+        y += lineHeight;
+    }
+    
+    geometry->bounds = sf::FloatRect(0.0f, 0.0f, blockWidth, lineHeight * (lines.size() - 1) + size);
+    geometry->lineCount = static_cast<int>(lines.size());
+    return geometry;
+}
@@ -0,0 +1,88 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Word-wrapped text whose glyph quads are built once and shared. A
+// TextLayout is a cheap handle (the geometry is reference counted), so it
+// can be positioned, copied into a WidgetTree or drawn into a DrawList
+// without touching the text again.
+class TextLayout : public sf::Drawable, public sf::Transformable {
+public:
+    struct Geometry {
+        sf::VertexArray vertices;
+        const sf::Font* font = nullptr;
+        unsigned int characterSize = 0;
+        sf::FloatRect bounds;
+        int lineCount = 0;
+    };
+    
+    TextLayout() = default;
+    explicit TextLayout(std::shared_ptr<const Geometry> geometry) : geometry(std::move(geometry)) {}
+    
+    sf::FloatRect getLocalBounds() const { return geometry ? geometry->bounds : sf::FloatRect(); }
+    int getLineCount() const { return geometry ? geometry->lineCount : 0; }
+
+private:
+    std::shared_ptr<const Geometry> geometry;
+    
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
+
+// Lays out and caches text by (string id, size, width, colour). Callers
+// pass the source string on every lookup but it is only read on a miss,
+// so a hit does no conversion or measuring. Changing the font drops
+// everything.
+class TextLayoutCache {
+public:
+    struct Style {
+        unsigned int characterSize = 24;
+        float maxWidth = 0.0f;          // 0 disables wrapping
+        float lineSpacing = 1.0f;
+        sf::Color color = sf::Color::White;
+        bool centered = false;          // centre each line in the block
+    };
+    
+    // Ids are chosen by the caller; makeId() packs an owner and a part.
+    static std::uint64_t makeId(std::uint32_t owner, std::uint32_t part) {
+        return (static_cast<std::uint64_t>(owner) << 32) | part;
+    }
+    
+    void setFont(const sf::Font* font);
+    
+    TextLayout get(std::uint64_t id, const std::wstring& text, const Style& style,
+                   const std::wstring& prefix = std::wstring());
+    
+    size_t size() const { return entries.size(); }
+
+private:
+    struct Key {
+        std::uint64_t id;
+        unsigned int characterSize;
+        float maxWidth;
+        sf::Uint32 color;
+        bool centered;
+        
+        bool operator==(const Key& other) const {
+            return id == other.id && characterSize == other.characterSize && maxWidth == other.maxWidth &&
+                   color == other.color && centered == other.centered;
+        }
+    };
+    
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+    
+    static const size_t MAX_ENTRIES = 1024;
+    
+    const sf::Font* font = nullptr;
+    std::unordered_map<Key, std::shared_ptr<const TextLayout::Geometry>, KeyHash> entries;
+    
+    std::shared_ptr<const TextLayout::Geometry> build(const sf::String& text, const Style& style) const;
+};
+
+#endif
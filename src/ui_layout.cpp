@@ -0,0 +1,111 @@
+#include "ui_layout.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+struct Entry {
+    bool startsLayout;
+    UILayout::Action action;
+    const char* label;
+    float x, y, width, height;
+    float spacing;
+    int row;
+};
+
+const Entry ENTRIES[] = {
+#define LAYOUT(id, x, y, width, height, spacing) {true, UILayout::Action::NONE, #id, x, y, width, height, spacing, 0},
+#define BUTTON(action, label, row) {false, UILayout::Action::action, label, 0, 0, 0, 0, 0, row},
+#define BUTTON_AT(action, label, x, y, width, height) {false, UILayout::Action::action, label, x, y, width, height, 0, -1},
+#include "ui_layouts.def"
+#undef LAYOUT
+#undef BUTTON
+#undef BUTTON_AT
+};
+
+}
+
+UILayout::UILayout()
+    : cells(static_cast<size_t>(Id::COUNT) * GRID_ROWS * GRID_COLUMNS, 0) {
+    
+    buttons.reserve(sizeof(ENTRIES) / sizeof(ENTRIES[0]));
+    
+    const Entry* column = nullptr;
+    size_t layout = 0;
+    for (const Entry& entry : ENTRIES) {
+        if (entry.startsLayout) {
+            if (column) {
+                layout++;
+            }
+            column = &entry;
+            ranges[layout].first = buttons.size();
+            continue;
+        }
+        
+        if (ranges[layout].count >= MAX_BUTTONS) {
+            std::cerr << "Too many buttons in layout " << column->label << ", ignoring " << entry.label << std::endl;
+            continue;
+        }
+        
+        Button button;
+        button.action = entry.action;
+        button.label = entry.label;
+        if (entry.row >= 0) {
+            button.x = column->x;
+            button.y = column->y + entry.row * (column->height + column->spacing);
+            button.width = column->width;
+            button.height = column->height;
+        } else {
+            button.x = entry.x;
+            button.y = entry.y;
+            button.width = entry.width;
+            button.height = entry.height;
+        }
+        buttons.push_back(button);
+        ranges[layout].count++;
+    }
+    
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        buildGrid(static_cast<Id>(i));
+    }
+}
+
+void UILayout::buildGrid(Id id) {
+    for (size_t i = 0; i < getButtonCount(id); ++i) {
+        const Button& button = getButton(id, i);
+        if (button.action == Action::NONE) {
+            continue;
+        }
+        
+        int firstColumn = std::max(0, static_cast<int>(button.x) / CELL_SIZE);
+        int lastColumn = std::min(GRID_COLUMNS - 1, static_cast<int>(button.x + button.width) / CELL_SIZE);
+        int firstRow = std::max(0, static_cast<int>(button.y) / CELL_SIZE);
+        int lastRow = std::min(GRID_ROWS - 1, static_cast<int>(button.y + button.height) / CELL_SIZE);
+        
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (int column = firstColumn; column <= lastColumn; ++column) {
+                cell(id, column, row) |= 1u << i;
+            }
+        }
+    }
+}
+
+int UILayout::hitTest(Id id, int x, int y) const {
+    if (x < 0 || y < 0 || x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT) {
+        return -1;
+    }
+    
+    uint32_t mask = cells[(index(id) * GRID_ROWS + y / CELL_SIZE) * GRID_COLUMNS + x / CELL_SIZE];
+    for (int i = 0; mask != 0; ++i, mask >>= 1) {
+        if (!(mask & 1u)) {
+            continue;
+        }
+        
+        const Button& button = getButton(id, i);
+        if (x >= button.x && x <= button.x + button.width &&
+            y >= button.y && y <= button.y + button.height) {
+            return i;
+        }
+    }
+    return -1;
+}
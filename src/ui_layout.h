@@ -0,0 +1,91 @@
+#ifndef UI_LAYOUT_H
+#define UI_LAYOUT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Button layouts for all screens, declared in ui_layouts.def and laid out
+// once into flat arrays. Each button carries a numeric action that
+// GameActions dispatches, and each screen has a coarse grid of cells with
+// a bitmask of the buttons overlapping them, so hit testing looks at one
+// cell instead of every button.
+class UILayout {
+public:
+    enum class Id : uint8_t {
+#define LAYOUT(id, x, y, width, height, spacing) id,
+#define BUTTON(action, label, row)
+#define BUTTON_AT(action, label, x, y, width, height)
+#include "ui_layouts.def"
+#undef LAYOUT
+#undef BUTTON
+#undef BUTTON_AT
+        COUNT
+    };
+    
+    enum class Action : uint8_t {
+        NONE,
+        LOGIN,
+        REGISTER,
+        CONFIRM_PASSWORD,
+        LOGIN_BACK,
+        LOGIN_INSTEAD,
+        TRY_DIFFERENT_NAME,
+        EXIT_GAME,
+        OPEN_SOLAR_SYSTEM,
+        OPEN_ACHIEVEMENTS,
+        OPEN_STATISTICS,
+        BACK_TO_MENU,
+        NEXT_QUESTION,
+        EXIT_QUIZ,
+        RETURN_TO_SOLAR_SYSTEM,
+        RETURN_TO_PLANET_INFO,
+        TAKE_PLANET_QUIZ,
+        TAKE_ANOTHER_QUIZ,
+        RETRY_INCORRECT,
+        STUDY_MORE,
+        COUNT
+    };
+    
+    struct Button {
+        Action action;
+        const char* label;
+        float x, y, width, height;
+    };
+    
+    static const int SCREEN_WIDTH = 1024;
+    static const int SCREEN_HEIGHT = 768;
+    
+    UILayout();
+    
+    size_t getButtonCount(Id id) const { return ranges[index(id)].count; }
+    const Button& getButton(Id id, size_t i) const { return buttons[ranges[index(id)].first + i]; }
+    
+    // Index of the clickable button under (x, y) in the layout, or -1.
+    int hitTest(Id id, int x, int y) const;
+
+private:
+    static const int CELL_SIZE = 64;
+    static const int GRID_COLUMNS = SCREEN_WIDTH / CELL_SIZE;
+    static const int GRID_ROWS = SCREEN_HEIGHT / CELL_SIZE;
+    static const size_t MAX_BUTTONS = 32;
+    
+    struct Range {
+        size_t first = 0;
+        size_t count = 0;
+    };
+    
+    std::vector<Button> buttons;
+    std::array<Range, static_cast<size_t>(Id::COUNT)> ranges;
+    std::vector<uint32_t> cells;
+    
+    static size_t index(Id id) { return static_cast<size_t>(id); }
+    uint32_t& cell(Id id, int column, int row) {
+        return cells[(index(id) * GRID_ROWS + row) * GRID_COLUMNS + column];
+    }
+    
+    void buildGrid(Id id);
+};
+
+#endif
@@ -0,0 +1,187 @@
+#include "virtual_list.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Visible rows of one frame, drawn through a view clipped to the list area.
+class ClippedRows : public sf::Drawable {
+public:
+    sf::FloatRect clip;
+    std::vector<std::pair<std::shared_ptr<const ListRow>, sf::Transform>> rows;
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        sf::View previous = target.getView();
+        sf::Vector2f size = previous.getSize();
+        sf::Vector2f origin = previous.getCenter() - size / 2.0f;
+        const sf::FloatRect& viewport = previous.getViewport();
+        
+        sf::View clipped(clip);
+        clipped.setViewport(sf::FloatRect(
+            viewport.left + (clip.left - origin.x) / size.x * viewport.width,
+            viewport.top + (clip.top - origin.y) / size.y * viewport.height,
+            clip.width / size.x * viewport.width,
+            clip.height / size.y * viewport.height));
+        target.setView(clipped);
+        
+        for (const auto& [row, transform] : rows) {
+            sf::RenderStates rowStates = states;
+            rowStates.transform *= transform;
+            target.draw(*row, rowStates);
+        }
+        target.setView(previous);
+    }
+};
+
+}
+
+void ListRow::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    for (const auto& part : parts) {
+        target.draw(*part, states);
+    }
+}
+
+VirtualList::VirtualList(const sf::FloatRect& area, float rowHeight, int columns)
+    : area(area)
+    , rowHeight(rowHeight)
+    , columns(std::max(1, columns))
+    , source(nullptr)
+    , offset(0.0)
+    , targetOffset(0.0) {
+}
+
+void VirtualList::setSource(ListDataSource* source) {
+    this->source = source;
+    offset = 0.0;
+    targetOffset = 0.0;
+    rows.clear();
+}
+
+void VirtualList::invalidate() {
+    rows.clear();
+    clampTarget();
+    offset = std::min(offset, getMaxOffset());
+}
+
+void VirtualList::scrollBy(double pixels) {
+    targetOffset += pixels;
+    clampTarget();
+}
+
+void VirtualList::scrollToStart() {
+    targetOffset = 0.0;
+}
+
+void VirtualList::scrollToEnd() {
+    targetOffset = getMaxOffset();
+}
+
+bool VirtualList::handleWheel(float delta, int x, int y) {
+    if (!area.contains(static_cast<float>(x), static_cast<float>(y))) {
+        return false;
+    }
+    scrollBy(-delta * rowHeight);
+    return true;
+}
+
+bool VirtualList::handleKey(sf::Keyboard::Key key) {
+    switch (key) {
+        case sf::Keyboard::Up: scrollBy(-rowHeight); return true;
+        case sf::Keyboard::Down: scrollBy(rowHeight); return true;
+        case sf::Keyboard::PageUp: scrollBy(-area.height); return true;
+        case sf::Keyboard::PageDown: scrollBy(area.height); return true;
+        case sf::Keyboard::Home: scrollToStart(); return true;
+        case sf::Keyboard::End: scrollToEnd(); return true;
+        default: return false;
+    }
+}
+
+bool VirtualList::update(float deltaTime) {
+    double remaining = targetOffset - offset;
+    if (remaining == 0.0) {
+        return false;
+    }
+    
+    if (std::abs(remaining) < 0.5) {
+        offset = targetOffset;
+    } else {
+        offset += remaining * (1.0 - std::exp(-SCROLL_RATE * deltaTime));
+    }
+    return true;
+}
+
+void VirtualList::draw(DrawList& frame) {
+    if (!source) {
+        return;
+    }
+    
+    size_t count = source->getRowCount();
+    size_t firstLine = static_cast<size_t>(offset / rowHeight);
+    size_t lastLine = std::min(getLineCount(), static_cast<size_t>((offset + area.height) / rowHeight) + 1);
+    size_t first = firstLine * columns;
+    size_t last = std::min(count, lastLine * columns);
+    
+    // Keep a margin of built rows so small scrolls do not rebuild them.
+    size_t margin = static_cast<size_t>(OVERSCAN_LINES) * columns;
+    rows.erase(rows.begin(), rows.lower_bound(first > margin ? first - margin : 0));
+    rows.erase(rows.lower_bound(last + margin), rows.end());
+    
+    auto visible = std::make_shared<ClippedRows>();
+    visible->clip = area;
+    visible->rows.reserve(last > first ? last - first : 0);
+    
+    sf::Vector2f cellSize(area.width / columns, rowHeight);
+    for (size_t i = first; i < last; ++i) {
+        auto& row = rows[i];
+        if (!row) {
+            auto built = std::make_shared<ListRow>();
+            source->buildRow(i, *built, cellSize);
+            row = built;
+        }
+        
+        sf::Transform transform;
+        transform.translate(area.left + (i % columns) * cellSize.x,
+                            area.top + static_cast<float>((i / columns) * static_cast<double>(rowHeight) - offset));
+        visible->rows.push_back({row, transform});
+    }
+    
+    if (!visible->rows.empty()) {
+        frame.drawShared(visible);
+    }
+    drawScrollBar(frame);
+}
+
+size_t VirtualList::getLineCount() const {
+    size_t count = source ? source->getRowCount() : 0;
+    return (count + columns - 1) / columns;
+}
+
+double VirtualList::getMaxOffset() const {
+    return std::max(0.0, getLineCount() * static_cast<double>(rowHeight) - area.height);
+}
+
+void VirtualList::clampTarget() {
+    targetOffset = std::max(0.0, std::min(targetOffset, getMaxOffset()));
+}
+
+void VirtualList::drawScrollBar(DrawList& frame) const {
+    double maxOffset = getMaxOffset();
+    if (maxOffset <= 0.0) {
+        return;
+    }
+    
+    double content = maxOffset + area.height;
+    float thumbHeight = std::max(24.0f, static_cast<float>(area.height * area.height / content));
+    float thumbY = area.top + static_cast<float>((area.height - thumbHeight) * (offset / maxOffset));
+    
+    sf::RectangleShape track(sf::Vector2f(6, area.height));
+    track.setPosition(area.left + area.width + 6, area.top);
+    track.setFillColor(sf::Color(60, 60, 90, 120));
+    frame.draw(track);
+    
+    sf::RectangleShape thumb(sf::Vector2f(6, thumbHeight));
+    thumb.setPosition(area.left + area.width + 6, thumbY);
+    thumb.setFillColor(sf::Color(150, 150, 220));
+    frame.draw(thumb);
+}
@@ -0,0 +1,88 @@
+#ifndef VIRTUAL_LIST_H
+#define VIRTUAL_LIST_H
+
+#include <SFML/Graphics.hpp>
+#include <map>
+#include <memory>
+#include <vector>
+#include "draw_list.h"
+
+// Geometry of one list row in row-local coordinates.
+class ListRow : public sf::Drawable {
+public:
+    template <typename T>
+    T& add(const T& drawable) {
+        auto copy = std::make_unique<T>(drawable);
+        T& ref = *copy;
+        parts.push_back(std::move(copy));
+        return ref;
+    }
+
+private:
+    std::vector<std::unique_ptr<sf::Drawable>> parts;
+    
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
+
+// Rows behind a VirtualList. They are requested one at a time, only when
+// they scroll into view.
+class ListDataSource {
+public:
+    virtual ~ListDataSource() = default;
+    
+    virtual size_t getRowCount() const = 0;
+    // Lays out entry index from (0, 0) in a cell of the given size.
+    virtual void buildRow(size_t index, ListRow& row, const sf::Vector2f& cellSize) = 0;
+};
+
+// A scrolling list that only keeps geometry for the rows on screen plus a
+// few on either side, so its cost does not depend on the number of
+// entries. Rows are laid out in a grid of fixed-height lines, clipped to
+// the list area, and the scroll offset eases toward its target.
+class VirtualList {
+public:
+    VirtualList(const sf::FloatRect& area, float rowHeight, int columns = 1);
+    
+    // Starts at the top with no rows built; the source must outlive the list.
+    void setSource(ListDataSource* source);
+    // Drops built rows after the source's data changed.
+    void invalidate();
+    
+    void scrollBy(double pixels);
+    void scrollToStart();
+    void scrollToEnd();
+    
+    // Return true when the wheel or key scrolled the list.
+    bool handleWheel(float delta, int x, int y);
+    bool handleKey(sf::Keyboard::Key key);
+    
+    // Eases the offset toward the scroll target; true while still moving.
+    bool update(float deltaTime);
+    bool isScrolling() const { return offset != targetOffset; }
+    
+    void draw(DrawList& frame);
+    
+    size_t getBuiltRowCount() const { return rows.size(); }
+    
+    static constexpr int OVERSCAN_LINES = 2;
+    static constexpr float SCROLL_RATE = 14.0f;
+
+private:
+    sf::FloatRect area;
+    float rowHeight;
+    int columns;
+    ListDataSource* source;
+    
+    // Doubles keep sub-pixel precision millions of pixels down the list.
+    double offset;
+    double targetOffset;
+    
+    std::map<size_t, std::shared_ptr<const ListRow>> rows;
+    
+    size_t getLineCount() const;
+    double getMaxOffset() const;
+    void clampTarget();
+    void drawScrollBar(DrawList& frame) const;
+};
+
+#endif
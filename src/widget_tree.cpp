@@ -0,0 +1,31 @@
+#include "widget_tree.h"
+
+void WidgetTree::clear() {
+    items.clear();
+    buttonShapes.clear();
+    built = false;
+}
+
+void WidgetTree::addButton(const sf::RectangleShape& shape, const sf::Text& label) {
+    buttonShapes.push_back(items.size());
+    add(shape);
+    add(label);
+}
+
+void WidgetTree::setButtonFill(size_t index, const sf::Color& color) {
+    if (index >= buttonShapes.size()) {
+        return;
+    }
+    
+    Item& item = items[buttonShapes[index]];
+    auto* shape = static_cast<sf::RectangleShape*>(item.drawable.get());
+    if (shape->getFillColor() != color) {
+        detach<sf::RectangleShape>(item)->setFillColor(color);
+    }
+}
+
+void WidgetTree::draw(DrawList& frame) const {
+    for (const auto& item : items) {
+        frame.drawShared(item.drawable);
+    }
+}
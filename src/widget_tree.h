@@ -0,0 +1,81 @@
+#ifndef WIDGET_TREE_H
+#define WIDGET_TREE_H
+
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <vector>
+#include <string>
+#include "draw_list.h"
+
+// Retained drawables for one screen. The owner rebuilds the tree only when
+// the UI revision or the bound data key it was built for changes; between
+// rebuilds the cached text and shape geometry is drawn as is. Button
+// backgrounds are tracked separately so hover colours can change without
+// a rebuild.
+//
+// Items are shared with published frames, so find() and setButtonFill()
+// copy an item before changing it if a frame still refers to it.
+class WidgetTree {
+public:
+    bool isStale(unsigned long revision, long long dataKey = 0) const {
+        return !built || builtRevision != revision || builtDataKey != dataKey;
+    }
+    
+    void markBuilt(unsigned long revision, long long dataKey = 0) {
+        built = true;
+        builtRevision = revision;
+        builtDataKey = dataKey;
+    }
+    
+    void clear();
+    
+    template <typename T>
+    T& add(const T& drawable, const std::string& id = "") {
+        auto copy = std::make_shared<T>(drawable);
+        T& ref = *copy;
+        items.push_back({std::move(copy), id});
+        return ref;
+    }
+    
+    template <typename T>
+    T* find(const std::string& id) {
+        for (auto& item : items) {
+            if (item.id == id) {
+                return detach<T>(item);
+            }
+        }
+        return nullptr;
+    }
+    
+    void addButton(const sf::RectangleShape& shape, const sf::Text& label);
+    void setButtonFill(size_t index, const sf::Color& color);
+    size_t getButtonCount() const { return buttonShapes.size(); }
+    
+    void draw(DrawList& frame) const;
+
+private:
+    struct Item {
+        std::shared_ptr<sf::Drawable> drawable;
+        std::string id;
+    };
+    
+    std::vector<Item> items;
+    std::vector<size_t> buttonShapes;
+    
+    template <typename T>
+    T* detach(Item& item) {
+        T* typed = dynamic_cast<T*>(item.drawable.get());
+        if (typed && item.drawable.use_count() > 1) {
+            auto copy = std::make_shared<T>(*typed);
+            typed = copy.get();
+            item.drawable = std::move(copy);
+        }
+        return typed;
+    }
+    
+    bool built = false;
+    unsigned long builtRevision = 0;
+    long long builtDataKey = 0;
+};
+
+#endif